@@ -0,0 +1,84 @@
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <optional>
+
+#include <autoload.hpp>
+
+#include "synthetic.hpp"
+
+namespace {
+void BM_CallDirect(benchmark::State& state) {
+  int value = 0;
+  for (auto _ : state) {
+    value = fn_00(value);
+    benchmark::DoNotOptimize(value);
+  }
+}
+
+void BM_CallDlsym(benchmark::State& state) {
+  auto path    = synthetic_library(0);
+  auto* handle = ::dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+  auto* fnc    = reinterpret_cast<int (*)(int)>(::dlsym(handle, "fn_00"));
+
+  int value = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(fnc);
+    value = fnc(value);
+    benchmark::DoNotOptimize(value);
+  }
+  ::dlclose(handle);
+}
+
+template <typename... Policies>
+void BM_CallLibrary(benchmark::State& state) {
+  auto path    = synthetic_library(0);
+  auto library = erl::Library<Synthetic64, Policies...>(path.c_str());
+
+  int value = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(library);
+    value = library->fn_00(value);
+    benchmark::DoNotOptimize(value);
+  }
+}
+
+// the library shares its first cache line with a counter that thread 0 keeps bumping
+template <typename... Policies>
+struct Neighbours {
+  alignas(64) std::atomic<int> writes{0};
+  erl::Library<Synthetic64, Policies...> library;
+};
+
+template <typename... Policies>
+void BM_CallContended(benchmark::State& state) {
+  static std::optional<Neighbours<Policies...> > shared;
+  if (state.thread_index() == 0) {
+    auto path = synthetic_library(0);
+    shared.emplace(0, erl::Library<Synthetic64, Policies...>(path.c_str()));
+  }
+
+  int value = 0;
+  for (auto _ : state) {
+    if (state.thread_index() == 0) {
+      shared->writes.fetch_add(1, std::memory_order_relaxed);
+    }
+    value = shared->library->fn_00(value);
+    benchmark::DoNotOptimize(value);
+  }
+  state.SetItemsProcessed(state.iterations());
+
+  if (state.thread_index() == 0) {
+    shared.reset();
+  }
+}
+}  // namespace
+
+BENCHMARK(BM_CallDirect);
+BENCHMARK(BM_CallDlsym);
+BENCHMARK(BM_CallLibrary<>);
+BENCHMARK(BM_CallLibrary<erl::lazy>);
+BENCHMARK(BM_CallLibrary<erl::instrumented>);
+BENCHMARK(BM_CallLibrary<erl::variants>);
+BENCHMARK(BM_CallContended<>)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_CallContended<erl::sealed>)->ThreadRange(1, 8)->UseRealTime();
@@ -0,0 +1,67 @@
+// Measures front-end time and peak memory of the compiler for Wrappers of different sizes.
+// Every configuration compiles benchmarks/compile_time/wrappers.cpp with -fsyntax-only.
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+struct Measurement {
+  double seconds       = 0;
+  long max_rss_kib     = 0;
+  bool succeeded       = false;
+};
+
+Measurement compile(int members, int wrappers) {
+  std::vector<std::string> args = {ERL_COMPILE_BENCH_CXX,
+                                   "-std=c++23",
+                                   "-fsyntax-only",
+                                   "-I" ERL_COMPILE_BENCH_INCLUDE,
+                                   "-DERL_COMPILE_MEMBERS=" + std::to_string(members),
+                                   "-DERL_COMPILE_WRAPPERS=" + std::to_string(wrappers),
+                                   ERL_COMPILE_BENCH_SOURCE};
+  std::vector<char*> argv;
+  for (auto& arg : args) {
+    argv.push_back(arg.data());
+  }
+  argv.push_back(nullptr);
+
+  auto start = std::chrono::steady_clock::now();
+  pid_t pid  = ::fork();
+  if (pid == 0) {
+    ::execvp(argv[0], argv.data());
+    ::_exit(127);
+  }
+
+  int status   = 0;
+  rusage usage = {};
+  ::wait4(pid, &status, 0, &usage);
+
+  Measurement result;
+  result.seconds     = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  result.max_rss_kib = usage.ru_maxrss;
+  result.succeeded   = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+  return result;
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  int wrappers = argc > 1 ? std::stoi(argv[1]) : 16;
+  auto baseline = compile(1, 1);
+
+  std::printf("%8s %9s %10s %12s %12s\n", "members", "wrappers", "time [s]", "per wrapper", "peak [MiB]");
+  for (int members : {1, 8, 32, 64}) {
+    auto result = compile(members, wrappers);
+    if (!result.succeeded) {
+      std::printf("%8d %9d compilation failed\n", members, wrappers);
+      return 1;
+    }
+    auto per_wrapper = (result.seconds - baseline.seconds) / wrappers;
+    std::printf("%8d %9d %10.3f %10.2fms %12.1f\n", members, wrappers, result.seconds, per_wrapper * 1000,
+                static_cast<double>(result.max_rss_kib) / 1024);
+  }
+}
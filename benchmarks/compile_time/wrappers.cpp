@@ -0,0 +1,40 @@
+// Compiled by autoload_compile_bench, not part of any target.
+// Instantiates ERL_COMPILE_WRAPPERS distinct Wrappers with ERL_COMPILE_MEMBERS members each.
+#include <utility>
+
+#include <autoload.hpp>
+
+#define ERL_MEMBER(N) int (*fn_##N)(int);
+#define ERL_MEMBER8(N) \
+  ERL_MEMBER(N##0) ERL_MEMBER(N##1) ERL_MEMBER(N##2) ERL_MEMBER(N##3) \
+  ERL_MEMBER(N##4) ERL_MEMBER(N##5) ERL_MEMBER(N##6) ERL_MEMBER(N##7)
+
+#if ERL_COMPILE_MEMBERS == 1
+#  define ERL_MEMBERS ERL_MEMBER(00)
+#elif ERL_COMPILE_MEMBERS == 8
+#  define ERL_MEMBERS ERL_MEMBER8(0)
+#elif ERL_COMPILE_MEMBERS == 32
+#  define ERL_MEMBERS ERL_MEMBER8(0) ERL_MEMBER8(1) ERL_MEMBER8(2) ERL_MEMBER8(3)
+#elif ERL_COMPILE_MEMBERS == 64
+#  define ERL_MEMBERS \
+    ERL_MEMBER8(0) ERL_MEMBER8(1) ERL_MEMBER8(2) ERL_MEMBER8(3) ERL_MEMBER8(4) ERL_MEMBER8(5) ERL_MEMBER8(6) ERL_MEMBER8(7)
+#else
+#  error "ERL_COMPILE_MEMBERS must be one of 1, 8, 32 or 64"
+#endif
+
+template <int Tag>
+struct Wrapper {
+  ERL_MEMBERS
+};
+
+template <typename W>
+void use(char const* path) {
+  auto library = erl::Library<W>(path);
+  (void)library->fn_00;
+}
+
+void use_all(char const* path) {
+  []<int... Tags>(char const* path, std::integer_sequence<int, Tags...>) {
+    (use<Wrapper<Tags> >(path), ...);
+  }(path, std::make_integer_sequence<int, ERL_COMPILE_WRAPPERS>{});
+}
@@ -0,0 +1,87 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+
+#include <autoload.hpp>
+
+#if ERL_HAS_ELF_LOOKUP
+#  include <linux/perf_event.h>
+#  include <sys/ioctl.h>
+#  include <sys/syscall.h>
+#  include <unistd.h>
+
+namespace {
+struct WideText {
+  int (*const* page_functions)(int);
+};
+
+inline constexpr std::size_t page_function_count = 2048;
+
+// user space iTLB misses of the calling thread, unavailable in most containers
+class ItlbMisses {
+  int fd = -1;
+
+public:
+  ItlbMisses() {
+    perf_event_attr attr{};
+    attr.type           = PERF_TYPE_HW_CACHE;
+    attr.size           = sizeof(attr);
+    attr.config         = PERF_COUNT_HW_CACHE_ITLB | (PERF_COUNT_HW_CACHE_OP_READ << 8U) |
+                  (PERF_COUNT_HW_CACHE_RESULT_MISS << 16U);
+    attr.disabled       = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv     = 1;
+    fd                  = static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+  }
+  ~ItlbMisses() {
+    if (fd >= 0) {
+      ::close(fd);
+    }
+  }
+  ItlbMisses(ItlbMisses const&)            = delete;
+  ItlbMisses& operator=(ItlbMisses const&) = delete;
+
+  [[nodiscard]] bool available() const noexcept { return fd >= 0; }
+
+  void start() const noexcept {
+    ::ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+    ::ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+  }
+
+  [[nodiscard]] std::uint64_t stop() const noexcept {
+    ::ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+    std::uint64_t count = 0;
+    return ::read(fd, &count, sizeof(count)) == sizeof(count) ? count : 0;
+  }
+};
+
+template <typename... Policies>
+void BM_CallWideText(benchmark::State& state) {
+  auto stats   = erl::LoadStats{};
+  auto library = erl::Library<WideText, Policies...>(ERL_BENCH_WIDE_TEXT_LIBRARY, stats);
+  auto misses  = ItlbMisses{};
+  auto const* functions = library->page_functions;
+
+  if (misses.available()) {
+    misses.start();
+  }
+  int value = 0;
+  for (auto _ : state) {
+    for (std::size_t idx = 0; idx < page_function_count; ++idx) {
+      value = functions[idx](value);
+    }
+    benchmark::DoNotOptimize(value);
+  }
+
+  auto calls = static_cast<double>(state.iterations() * page_function_count);
+  if (misses.available()) {
+    state.counters["itlb_misses_per_call"] = static_cast<double>(misses.stop()) / calls;
+  }
+  state.counters["huge_text_bytes"] = static_cast<double>(stats.huge_text_bytes);
+  state.SetItemsProcessed(static_cast<std::int64_t>(calls));
+}
+}  // namespace
+
+BENCHMARK(BM_CallWideText<>);
+BENCHMARK(BM_CallWideText<erl::huge_text>);
+#endif
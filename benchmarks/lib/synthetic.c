@@ -0,0 +1,26 @@
+#if defined(_WIN32) || defined(_WIN64)
+#define EXPORT __declspec(dllexport)
+#else
+#define EXPORT
+#endif
+
+#define DEFINE_FN(N) \
+  EXPORT int fn_##N(int value) { return value + 1##N; }
+#define DEFINE_FN8(N) \
+  DEFINE_FN(N##0)     \
+  DEFINE_FN(N##1)     \
+  DEFINE_FN(N##2)     \
+  DEFINE_FN(N##3)     \
+  DEFINE_FN(N##4)     \
+  DEFINE_FN(N##5)     \
+  DEFINE_FN(N##6)     \
+  DEFINE_FN(N##7)
+
+DEFINE_FN8(0)
+DEFINE_FN8(1)
+DEFINE_FN8(2)
+DEFINE_FN8(3)
+DEFINE_FN8(4)
+DEFINE_FN8(5)
+DEFINE_FN8(6)
+DEFINE_FN8(7)
@@ -0,0 +1,53 @@
+#if defined(_WIN32) || defined(_WIN64)
+#define EXPORT __declspec(dllexport)
+#define PAGE_ALIGNED __declspec(align(4096))
+#else
+#define EXPORT
+#define PAGE_ALIGNED __attribute__((aligned(4096), noinline))
+#endif
+
+/* 2048 functions on pages of their own, spanning 8 MiB of text. Calling all of them needs far more iTLB entries
+   than the CPU has for 4 KiB pages, but only two or three once the text sits on 2 MiB pages. */
+#define DEFINE_FN(N) \
+  EXPORT PAGE_ALIGNED int page_fn_##N(int value) { return value + 1##N; }
+#define DEFINE_FN8(N) \
+  DEFINE_FN(N##0)     \
+  DEFINE_FN(N##1)     \
+  DEFINE_FN(N##2)     \
+  DEFINE_FN(N##3)     \
+  DEFINE_FN(N##4)     \
+  DEFINE_FN(N##5)     \
+  DEFINE_FN(N##6)     \
+  DEFINE_FN(N##7)
+#define DEFINE_FN64(N) \
+  DEFINE_FN8(N##0)     \
+  DEFINE_FN8(N##1)     \
+  DEFINE_FN8(N##2)     \
+  DEFINE_FN8(N##3)     \
+  DEFINE_FN8(N##4)     \
+  DEFINE_FN8(N##5)     \
+  DEFINE_FN8(N##6)     \
+  DEFINE_FN8(N##7)
+#define DEFINE_FN512(N) \
+  DEFINE_FN64(N##0)     \
+  DEFINE_FN64(N##1)     \
+  DEFINE_FN64(N##2)     \
+  DEFINE_FN64(N##3)     \
+  DEFINE_FN64(N##4)     \
+  DEFINE_FN64(N##5)     \
+  DEFINE_FN64(N##6)     \
+  DEFINE_FN64(N##7)
+
+DEFINE_FN512(0)
+DEFINE_FN512(1)
+DEFINE_FN512(2)
+DEFINE_FN512(3)
+
+#define ENTRY(N) page_fn_##N,
+#define ENTRY8(N) ENTRY(N##0) ENTRY(N##1) ENTRY(N##2) ENTRY(N##3) ENTRY(N##4) ENTRY(N##5) ENTRY(N##6) ENTRY(N##7)
+#define ENTRY64(N) \
+  ENTRY8(N##0) ENTRY8(N##1) ENTRY8(N##2) ENTRY8(N##3) ENTRY8(N##4) ENTRY8(N##5) ENTRY8(N##6) ENTRY8(N##7)
+#define ENTRY512(N) \
+  ENTRY64(N##0) ENTRY64(N##1) ENTRY64(N##2) ENTRY64(N##3) ENTRY64(N##4) ENTRY64(N##5) ENTRY64(N##6) ENTRY64(N##7)
+
+EXPORT int (*const page_functions[2048])(int) = {ENTRY512(0) ENTRY512(1) ENTRY512(2) ENTRY512(3)};
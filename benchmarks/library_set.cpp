@@ -0,0 +1,39 @@
+#include <benchmark/benchmark.h>
+
+#include <autoload/library_set.hpp>
+
+#include "synthetic.hpp"
+
+namespace {
+template <std::size_t>
+using Repeat = Synthetic64;
+
+template <std::size_t... Idx>
+void load_sequential(benchmark::State& state, std::index_sequence<Idx...>) {
+  std::string paths[] = {synthetic_library(Idx)...};
+  for (auto _ : state) {
+    auto libraries = std::tuple<erl::Library<Repeat<Idx> >...>{erl::Library<Repeat<Idx> >(paths[Idx])...};
+    benchmark::DoNotOptimize(libraries);
+  }
+}
+
+template <std::size_t... Idx>
+void load_parallel(benchmark::State& state, std::index_sequence<Idx...>) {
+  std::string paths[] = {synthetic_library(Idx)...};
+  for (auto _ : state) {
+    auto libraries = erl::LibrarySet<Repeat<Idx>...>(paths[Idx]...);
+    benchmark::DoNotOptimize(libraries);
+  }
+}
+
+void BM_LoadSequential(benchmark::State& state) {
+  load_sequential(state, std::make_index_sequence<synthetic_library_count>{});
+}
+
+void BM_LoadLibrarySet(benchmark::State& state) {
+  load_parallel(state, std::make_index_sequence<synthetic_library_count>{});
+}
+}  // namespace
+
+BENCHMARK(BM_LoadSequential)->Unit(benchmark::kMicrosecond)->UseRealTime();
+BENCHMARK(BM_LoadLibrarySet)->Unit(benchmark::kMicrosecond)->UseRealTime();
@@ -0,0 +1,88 @@
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <filesystem>
+#include <optional>
+
+#include <autoload.hpp>
+
+#include "synthetic.hpp"
+
+namespace {
+using clock = std::chrono::steady_clock;
+
+template <typename Wrapper>
+void BM_Construct(benchmark::State& state) {
+  auto path = synthetic_library(0);
+  for (auto _ : state) {
+    auto start   = clock::now();
+    auto library = erl::Library<Wrapper>(path.c_str());
+    auto end     = clock::now();
+
+    benchmark::DoNotOptimize(library);
+    state.SetIterationTime(std::chrono::duration<double>(end - start).count());
+  }
+  state.counters["members"] = static_cast<double>(erl::reflection::arity<Wrapper>);
+}
+
+template <typename Wrapper>
+void BM_Destroy(benchmark::State& state) {
+  auto path = synthetic_library(0);
+  for (auto _ : state) {
+    auto library = std::optional<erl::Library<Wrapper> >{std::in_place, path.c_str()};
+
+    auto start = clock::now();
+    library.reset();
+    auto end = clock::now();
+
+    state.SetIterationTime(std::chrono::duration<double>(end - start).count());
+  }
+}
+
+// keeps the library mapped so iterations measure symbol resolution rather than mapping the file
+template <typename Wrapper, typename... Policies>
+void BM_Resolve(benchmark::State& state) {
+  auto path      = synthetic_library(0);
+  auto directory = std::filesystem::temp_directory_path() / ("autoload_bench_cache_" + std::to_string(::getpid()));
+  std::filesystem::create_directories(directory);
+  erl::set_symbol_cache_directory(directory.string());
+
+  auto resident = erl::Library<Wrapper, Policies...>(path.c_str());
+  for (auto _ : state) {
+    auto start   = clock::now();
+    auto library = erl::Library<Wrapper, Policies...>(path.c_str());
+    auto end     = clock::now();
+
+    benchmark::DoNotOptimize(library);
+    state.SetIterationTime(std::chrono::duration<double>(end - start).count());
+  }
+
+  erl::set_symbol_cache_directory("");
+  std::filesystem::remove_all(directory);
+  state.counters["members"] = static_cast<double>(erl::reflection::arity<Wrapper>);
+}
+
+void BM_RawDlopen(benchmark::State& state) {
+  auto path = synthetic_library(0);
+  for (auto _ : state) {
+    auto start  = clock::now();
+    auto handle = ::dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    auto end    = clock::now();
+
+    benchmark::DoNotOptimize(handle);
+    ::dlclose(handle);
+    state.SetIterationTime(std::chrono::duration<double>(end - start).count());
+  }
+}
+}  // namespace
+
+BENCHMARK(BM_RawDlopen)->UseManualTime()->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Construct<Synthetic1>)->UseManualTime()->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Construct<Synthetic8>)->UseManualTime()->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Construct<Synthetic32>)->UseManualTime()->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Construct<Synthetic64>)->UseManualTime()->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Resolve<Synthetic64>)->UseManualTime()->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Resolve<Synthetic64, erl::cached>)->UseManualTime()->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Resolve<Synthetic64, erl::variants>)->UseManualTime()->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Destroy<Synthetic1>)->UseManualTime()->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Destroy<Synthetic64>)->UseManualTime()->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,63 @@
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#include <autoload.hpp>
+
+#include "synthetic.hpp"
+
+#if ERL_HAS_MEMFD
+namespace {
+using clock = std::chrono::steady_clock;
+
+std::vector<std::byte> read_image(std::string const& path) {
+  auto file  = std::ifstream(path, std::ios::binary);
+  auto bytes = std::vector<char>(std::istreambuf_iterator<char>(file), {});
+  auto image = std::vector<std::byte>(bytes.size());
+  std::memcpy(image.data(), bytes.data(), bytes.size());
+  return image;
+}
+
+void BM_LoadFromMemory(benchmark::State& state) {
+  auto image = read_image(synthetic_library(0));
+  for (auto _ : state) {
+    auto start   = clock::now();
+    auto library = erl::Library<Synthetic8>(std::span<std::byte const>{image});
+    auto end     = clock::now();
+
+    benchmark::DoNotOptimize(library);
+    state.SetIterationTime(std::chrono::duration<double>(end - start).count());
+  }
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * image.size()));
+}
+
+// the route taken without in-memory loading: write the image out, load it and remove the file again
+void BM_LoadViaTempFile(benchmark::State& state) {
+  auto image     = read_image(synthetic_library(0));
+  auto directory = std::filesystem::temp_directory_path();
+  for (auto _ : state) {
+    auto start = clock::now();
+    auto path  = directory / ("autoload_bench_image_" + std::to_string(::getpid()) + ".so");
+    {
+      auto file = std::ofstream(path, std::ios::binary);
+      file.write(reinterpret_cast<char const*>(image.data()), static_cast<std::streamsize>(image.size()));
+    }
+    auto library = erl::Library<Synthetic8>(path.string());
+    std::filesystem::remove(path);
+    auto end = clock::now();
+
+    benchmark::DoNotOptimize(library);
+    state.SetIterationTime(std::chrono::duration<double>(end - start).count());
+  }
+  state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * image.size()));
+}
+}  // namespace
+
+BENCHMARK(BM_LoadFromMemory)->UseManualTime()->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_LoadViaTempFile)->UseManualTime()->Unit(benchmark::kMicrosecond);
+#endif
@@ -0,0 +1,66 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstddef>
+
+#include <autoload.hpp>
+
+#include "synthetic.hpp"
+
+#if ERL_HAS_ELF_LOOKUP
+namespace {
+using Indexed = erl::Library<Synthetic64, erl::reverse_lookup>;
+
+// return addresses land inside functions, not on their first byte
+std::array<void const*, 64> sample(Indexed const& library) {
+  auto addresses = std::array<void const*, 64>{};
+  std::size_t idx = 0;
+  erl::reflection::for_each_member(*library, [&]<std::size_t>(auto member) {
+    addresses[idx++] = reinterpret_cast<char const*>(member) + 1;
+  });
+  return addresses;
+}
+
+void BM_SymbolizeDladdr(benchmark::State& state) {
+  auto path      = synthetic_library(0);
+  auto library   = Indexed(path.c_str());
+  auto addresses = sample(library);
+
+  for (auto _ : state) {
+    for (auto const* address : addresses) {
+      Dl_info info{};
+      ::dladdr(address, &info);
+      benchmark::DoNotOptimize(info.dli_sname);
+    }
+  }
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * addresses.size()));
+}
+
+void BM_SymbolizeIndex(benchmark::State& state) {
+  auto path      = synthetic_library(0);
+  auto library   = Indexed(path.c_str());
+  auto addresses = sample(library);
+  auto out       = std::array<erl::platform::elf::AddressInfo, 64>{};
+
+  for (auto _ : state) {
+    library.address_index().symbolize(addresses, out);
+    benchmark::DoNotOptimize(out);
+  }
+  state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * addresses.size()));
+}
+
+void BM_BuildAddressIndex(benchmark::State& state) {
+  auto path    = synthetic_library(0);
+  auto library = erl::Library<Synthetic64>(path.c_str());
+
+  for (auto _ : state) {
+    auto index = erl::platform::elf::AddressIndex(library.native_handle());
+    benchmark::DoNotOptimize(index);
+  }
+}
+}  // namespace
+
+BENCHMARK(BM_SymbolizeDladdr);
+BENCHMARK(BM_SymbolizeIndex);
+BENCHMARK(BM_BuildAddressIndex)->Unit(benchmark::kMicrosecond);
+#endif
@@ -0,0 +1,38 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+// mirrors the exports of lib/synthetic.c
+#define ERL_BENCH_FN(N) int (*fn_##N)(int);
+#define ERL_BENCH_FN8(N) \
+  ERL_BENCH_FN(N##0) ERL_BENCH_FN(N##1) ERL_BENCH_FN(N##2) ERL_BENCH_FN(N##3) \
+  ERL_BENCH_FN(N##4) ERL_BENCH_FN(N##5) ERL_BENCH_FN(N##6) ERL_BENCH_FN(N##7)
+
+struct Synthetic1 {
+  ERL_BENCH_FN(00)
+};
+
+struct Synthetic8 {
+  ERL_BENCH_FN8(0)
+};
+
+struct Synthetic32 {
+  ERL_BENCH_FN8(0) ERL_BENCH_FN8(1) ERL_BENCH_FN8(2) ERL_BENCH_FN8(3)
+};
+
+struct Synthetic64 {
+  ERL_BENCH_FN8(0) ERL_BENCH_FN8(1) ERL_BENCH_FN8(2) ERL_BENCH_FN8(3)
+  ERL_BENCH_FN8(4) ERL_BENCH_FN8(5) ERL_BENCH_FN8(6) ERL_BENCH_FN8(7)
+};
+
+#undef ERL_BENCH_FN8
+#undef ERL_BENCH_FN
+
+inline constexpr std::size_t synthetic_library_count = 16;
+
+// linked directly into autoload_bench as the baseline for calls
+extern "C" int fn_00(int);
+
+inline std::string synthetic_library(std::size_t idx) {
+  return ERL_BENCH_LIBRARY_DIR "/libautoload_synthetic_" + std::to_string(idx) + ".so";
+}
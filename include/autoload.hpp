@@ -23,11 +23,24 @@ SOFTWARE.
 */
 #pragma once
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
 #include <string_view>
 #include <string>
+#include <tuple>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #if defined(__clang__)
 #  if __has_feature(reflection)
@@ -41,8 +54,7 @@ SOFTWARE.
 
 #if ERL_HAS_REFLECTION
 #  include <experimental/meta>
-#else
-#  include <array>
+#  include <ranges>
 #endif
 
 #if (defined(_WIN32) || defined(_WIN64))
@@ -55,6 +67,61 @@ SOFTWARE.
 #  endif
 #else
 #  include <dlfcn.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+// glibc, musl, bionic and Apple keep dlerror() state per thread, Windows does the same for GetLastError()
+#if !defined(ERL_DLERROR_THREAD_LOCAL)
+#  if defined(__linux__) || defined(__APPLE__) || defined(_WIN32) || defined(_WIN64)
+#    define ERL_DLERROR_THREAD_LOCAL true
+#  else
+#    define ERL_DLERROR_THREAD_LOCAL false
+#  endif
+#endif
+
+#if defined(__linux__) && !defined(ERL_HAS_ELF_LOOKUP)
+#  define ERL_HAS_ELF_LOOKUP true
+#elif !defined(ERL_HAS_ELF_LOOKUP)
+#  define ERL_HAS_ELF_LOOKUP false
+#endif
+
+// glibc is the only loader with working dlmopen namespaces
+#if defined(__GLIBC__) && !defined(ERL_HAS_DLMOPEN)
+#  define ERL_HAS_DLMOPEN true
+#elif !defined(ERL_HAS_DLMOPEN)
+#  define ERL_HAS_DLMOPEN false
+#endif
+
+// set to false to compile the probes of `erl::instrumented` out, leaving the policy without effect
+#if !defined(ERL_INSTRUMENTATION)
+#  define ERL_INSTRUMENTATION true
+#endif
+
+#if defined(__linux__) && !defined(ERL_HAS_MEMFD)
+#  define ERL_HAS_MEMFD true
+#elif !defined(ERL_HAS_MEMFD)
+#  define ERL_HAS_MEMFD false
+#endif
+
+#if ERL_HAS_MEMFD
+#  include <cerrno>
+#  include <cstdio>
+#  include <cstring>
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <unistd.h>
+#endif
+
+#if ERL_HAS_ELF_LOOKUP
+#  include <cstdlib>
+#  include <cstring>
+#  include <elf.h>
+#  include <fcntl.h>
+#  include <link.h>
+#  include <sys/mman.h>
+#  include <unistd.h>
 #endif
 
 #include <stdexcept>
@@ -65,6 +132,50 @@ struct LibraryError : std::runtime_error {
   using std::runtime_error::runtime_error;
 };
 
+/// Thrown once per load, listing every required symbol that could not be found.
+struct MissingSymbolError : LibraryError {
+  /// The library the symbols were looked up in, empty if the platform cannot tell.
+  std::string path;
+  std::vector<std::string_view> symbols;
+
+  MissingSymbolError(std::string path_, std::vector<std::string_view> symbols_)
+      : LibraryError(describe(path_, symbols_))
+      , path(std::move(path_))
+      , symbols(std::move(symbols_)) {}
+
+private:
+  static std::string describe(std::string_view path, std::vector<std::string_view> const& symbols) {
+    std::string message = path.empty() ? "" : std::string{path} + ": ";
+    message += symbols.size() == 1 ? "undefined symbol: " : "undefined symbols: ";
+    for (std::size_t idx = 0; idx < symbols.size(); ++idx) {
+      if (idx != 0) {
+        message += ", ";
+      }
+      message += symbols[idx];
+    }
+    return message;
+  }
+};
+
+/// Loader options, combined with `|` and selected per `Library` type through the `load_flags` policy.
+/// The default binds every symbol at load time and keeps the library's symbols out of the global scope.
+enum class LoadFlag : unsigned {
+  none         = 0,
+  lazy_binding = 1U << 0U,  // bind functions on first call (RTLD_LAZY), dlopen only
+  global       = 1U << 1U,  // make the symbols available to libraries loaded later (RTLD_GLOBAL), dlopen only
+  deep_bind    = 1U << 2U,  // prefer the library's own symbols over global ones (RTLD_DEEPBIND), glibc only
+  no_delete    = 1U << 3U,  // never unmap the library, even after the last handle is closed
+  no_load      = 1U << 4U,  // only bind to a library that is already loaded, fail otherwise
+};
+
+constexpr LoadFlag operator|(LoadFlag lhs, LoadFlag rhs) noexcept {
+  return static_cast<LoadFlag>(static_cast<unsigned>(lhs) | static_cast<unsigned>(rhs));
+}
+
+constexpr bool has_flag(LoadFlag flags, LoadFlag flag) noexcept {
+  return (static_cast<unsigned>(flags) & static_cast<unsigned>(flag)) != 0;
+}
+
 namespace platform {
 #if (defined(_WIN32) || defined(_WIN64))
 using handle_type = HINSTANCE;
@@ -74,14 +185,27 @@ using handle_type = void*;
 using symbol_type = void*;
 #endif
 
-#if (defined(_WIN32) || defined(_WIN64))
 namespace _impl {
+#if (defined(_WIN32) || defined(_WIN64))
 inline void local_free(void* ptr) {
   ::LocalFree(ptr);
 }
-}  // namespace _impl
 #endif
 
+// held while calling into the loader and reading its error, which only needs a lock where the error state is
+// shared between threads
+#if ERL_DLERROR_THREAD_LOCAL
+struct ErrorScope {};
+#else
+inline std::mutex error_mutex;
+
+struct ErrorScope {
+  std::lock_guard<std::mutex> lock{error_mutex};
+};
+#endif
+}  // namespace _impl
+
+/// Returns and consumes the message of the last loader error on the calling thread.
 inline std::string get_last_error() {
 #if (defined(_WIN32) || defined(_WIN64))
   DWORD error_id = GetLastError();
@@ -89,18 +213,18 @@ inline std::string get_last_error() {
     return {};
   }
 
-  LPTSTR buffer = nullptr;
+  LPSTR buffer = nullptr;
   auto size =
       FormatMessageA(FORMAT_MESSAGE_ALLOCATE_BUFFER | FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_IGNORE_INSERTS, NULL,
-                     error_id, MAKELANGID(LANG_NEUTRAL, SUBLANG_DEFAULT), (LPTSTR)&buffer, 0, NULL);
+                     error_id, MAKELANGID(LANG_NEUTRAL, SUBLANG_DEFAULT), (LPSTR)&buffer, 0, NULL);
+  SetLastError(0);
 
   if (size == 0) {
-    return std::format("Invalid error code {}", error_id);
+    return "Invalid error code " + std::to_string(error_id);
   }
-  auto msg = std::unique_ptr<LPTSTR, void (*)(ptr)>(buffer, &_impl::local_free);
+  auto msg = std::unique_ptr<char, void (*)(void*)>(buffer, &_impl::local_free);
   return std::string(msg.get(), size);
 #else
-  // TODO this might not be thread-safe
   char const* error_msg = ::dlerror();
   if (error_msg == nullptr) {
     return {};
@@ -109,260 +233,1253 @@ inline std::string get_last_error() {
 #endif
 }
 
-inline handle_type load_library(std::string_view path) {
+namespace _impl {
+// calls fnc with a null-terminated copy of str, using the stack for anything that fits a path
+template <typename F>
+decltype(auto) with_c_str(std::string_view str, F&& fnc) {
+  constexpr std::size_t buffer_size = 4096;
+  if (str.size() < buffer_size) {
+    char buffer[buffer_size];
+    std::copy(str.begin(), str.end(), std::begin(buffer));
+    buffer[str.size()] = '\0';
+    return std::forward<F>(fnc)(static_cast<char const*>(buffer));
+  }
+  return std::forward<F>(fnc)(std::string{str}.c_str());
+}
+
+// must be called right after the failing call, on the same thread and within the same ErrorScope
+inline std::string take_error(char const* fallback, char const* subject) {
+  auto message = get_last_error();
+  if (message.empty()) {
+    message = std::string{fallback} + subject;
+  }
+  return message;
+}
+
+// drops errors left behind by earlier calls so they cannot be reported for the next one
+inline void clear_error() noexcept {
+#if (defined(_WIN32) || defined(_WIN64))
+  SetLastError(0);
+#else
+  (void)::dlerror();
+#endif
+}
+
+#if !(defined(_WIN32) || defined(_WIN64))
+constexpr int native_flags(LoadFlag flags) noexcept {
+  int mode = has_flag(flags, LoadFlag::lazy_binding) ? RTLD_LAZY : RTLD_NOW;
+  mode |= has_flag(flags, LoadFlag::global) ? RTLD_GLOBAL : RTLD_LOCAL;
+#  ifdef RTLD_DEEPBIND
+  mode |= has_flag(flags, LoadFlag::deep_bind) ? RTLD_DEEPBIND : 0;
+#  endif
+  mode |= has_flag(flags, LoadFlag::no_delete) ? RTLD_NODELETE : 0;
+  mode |= has_flag(flags, LoadFlag::no_load) ? RTLD_NOLOAD : 0;
+  return mode;
+}
+#endif
+}  // namespace _impl
+
+inline handle_type load_library(char const* path, LoadFlag flags = LoadFlag::none) {
+  [[maybe_unused]] auto scope = _impl::ErrorScope{};
+  _impl::clear_error();
 #if (defined(_WIN32) || defined(_WIN64))
-  handle_type handle = ::LoadLibraryExA(std::string{path}.c_str(), NULL, NULL);
+  handle_type handle = nullptr;
+  if (has_flag(flags, LoadFlag::no_load)) {
+    // takes a reference just like LoadLibrary, so the handle is released with FreeLibrary all the same
+    ::GetModuleHandleExA(0, path, &handle);
+  } else {
+    handle = ::LoadLibraryExA(path, NULL, NULL);
+  }
+  if (static_cast<bool>(handle) && has_flag(flags, LoadFlag::no_delete)) {
+    HMODULE pinned = nullptr;
+    ::GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_PIN, path, &pinned);
+  }
 #else
-  handle_type handle = ::dlopen(std::string{path}.c_str(), RTLD_NOW | RTLD_LOCAL);
+  handle_type handle = ::dlopen(path, _impl::native_flags(flags));
 #endif
   if (!static_cast<bool>(handle)) {
-    throw LibraryError(get_last_error());
+    throw LibraryError(_impl::take_error(has_flag(flags, LoadFlag::no_load) ? "not loaded: " : "cannot open ", path));
+  }
+  return handle;
+}
+
+inline handle_type load_library(std::string_view path, LoadFlag flags = LoadFlag::none) {
+  return _impl::with_c_str(path, [flags](char const* str) { return load_library(str, flags); });
+}
+
+#if ERL_HAS_DLMOPEN
+/// Loads a private copy of the library and its dependencies into a new link-map namespace.
+/// glibc provides 15 namespaces besides the default one, a namespace is reused once everything in it is closed.
+/// `LoadFlag::global` is rejected by glibc for new namespaces.
+inline handle_type load_isolated_library(char const* path, LoadFlag flags = LoadFlag::none) {
+  [[maybe_unused]] auto scope = _impl::ErrorScope{};
+  _impl::clear_error();
+  handle_type handle = ::dlmopen(LM_ID_NEWLM, path, _impl::native_flags(flags));
+  if (handle == nullptr) {
+    throw LibraryError(_impl::take_error("cannot open ", path));
   }
   return handle;
 }
+#endif
+
+#if ERL_HAS_MEMFD
+/// A library image that lives in a sealed anonymous file instead of on the filesystem.
+/// The loader recognizes libraries it already loaded by their path, so the descriptor must stay open (and its
+/// number taken) until the library is unloaded again. Otherwise a later image could reuse the path.
+class MemoryImage {
+  int fd = -1;
+  char name[32]{};
+
+  static LibraryError error(char const* what) { return LibraryError(std::string{what} + ": " + std::strerror(errno)); }
+
+  void create() {
+    fd = ::memfd_create("erl-image", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (fd < 0) {
+      throw error("memfd_create");
+    }
+    name_fd(fd);
+  }
+
+  void write(std::byte const* data, std::size_t size) {
+    while (size != 0) {
+      auto written = ::write(fd, data, size);
+      if (written < 0 && errno == EINTR) {
+        continue;
+      }
+      if (written <= 0) {
+        throw error("cannot write library image");
+      }
+      data += written;
+      size -= static_cast<std::size_t>(written);
+    }
+  }
+
+  void seal() {
+    // the loader maps the image privately, nobody gets to change it underneath
+    ::fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL);
+  }
+
+  void name_fd(int file) { std::snprintf(name, sizeof(name), "/proc/self/fd/%d", file); }
+
+public:
+  /// Copies `image` into a new anonymous file.
+  explicit MemoryImage(std::span<std::byte const> image) {
+    create();
+    try {
+      write(image.data(), image.size());
+    } catch (...) {
+      ::close(fd);
+      throw;
+    }
+    seal();
+  }
+
+  /// Regular files (including memfds) are loaded through a duplicate of `file`, anything else (ie. pipes or sockets)
+  /// is read to the end and copied. `file` stays owned by the caller.
+  explicit MemoryImage(int file) {
+    struct stat info {};
+    if (::fstat(file, &info) != 0) {
+      throw error("cannot stat library image");
+    }
+    if (S_ISREG(info.st_mode)) {
+      fd = ::fcntl(file, F_DUPFD_CLOEXEC, 0);
+      if (fd < 0) {
+        throw error("cannot duplicate library image");
+      }
+      name_fd(fd);
+      return;
+    }
+
+    create();
+    try {
+      std::byte buffer[16384];
+      while (true) {
+        auto count = ::read(file, buffer, sizeof(buffer));
+        if (count < 0 && errno == EINTR) {
+          continue;
+        }
+        if (count < 0) {
+          throw error("cannot read library image");
+        }
+        if (count == 0) {
+          break;
+        }
+        write(buffer, static_cast<std::size_t>(count));
+      }
+    } catch (...) {
+      ::close(fd);
+      throw;
+    }
+    seal();
+  }
+
+  ~MemoryImage() {
+    if (fd >= 0) {
+      ::close(fd);
+    }
+  }
+
+  MemoryImage(MemoryImage const&)            = delete;
+  MemoryImage& operator=(MemoryImage const&) = delete;
+
+  [[nodiscard]] char const* path() const noexcept { return name; }
+
+  /// Hands the descriptor over to the caller, who closes it after unloading the library.
+  [[nodiscard]] int release() noexcept { return std::exchange(fd, -1); }
+};
+#endif
 
 inline void unload_library(handle_type handle) {
+  [[maybe_unused]] auto scope = _impl::ErrorScope{};
 #if (defined(_WIN32) || defined(_WIN64))
-  ::FreeLibrary(handle);
+  if (::FreeLibrary(handle) == 0) {
 #else
-  ::dlclose(handle);
+  if (::dlclose(handle) != 0) {
 #endif
+    // unloading cannot report errors, do not leave them behind for unrelated calls either
+    _impl::clear_error();
+  }
 }
 
-inline symbol_type get_symbol(handle_type handle, std::string_view name) {
+/// Like `get_symbol`, but returns `nullptr` instead of throwing if the symbol does not exist.
+inline symbol_type find_symbol(handle_type handle, char const* name) noexcept {
+  [[maybe_unused]] auto scope = _impl::ErrorScope{};
 #if (defined(_WIN32) || defined(_WIN64))
-  symbol_type addr = ::GetProcAddress(handle, std::string{name}.c_str());
+  symbol_type addr = ::GetProcAddress(handle, name);
 #else
-  symbol_type addr = ::dlsym(handle, std::string{name}.c_str());
+  symbol_type addr = ::dlsym(handle, name);
 #endif
+  if (!bool(addr)) {
+    _impl::clear_error();
+  }
+  return addr;
+}
 
+inline symbol_type get_symbol(handle_type handle, char const* name) {
+  [[maybe_unused]] auto scope = _impl::ErrorScope{};
+  _impl::clear_error();
+#if (defined(_WIN32) || defined(_WIN64))
+  symbol_type addr = ::GetProcAddress(handle, name);
+#else
+  symbol_type addr = ::dlsym(handle, name);
+#endif
   if (!bool(addr)) {
-    throw LibraryError(get_last_error());
+    throw LibraryError(_impl::take_error("undefined symbol: ", name));
   }
   return addr;
 }
 
-}  // namespace platform
+inline symbol_type get_symbol(handle_type handle, std::string_view name) {
+  return _impl::with_c_str(name, [&](char const* str) { return get_symbol(handle, str); });
+}
 
-#if ERL_HAS_REFLECTION
-namespace meta {
-namespace impl {
-template <auto... Vs>
-struct Replicator {
-  template <typename F>
-  constexpr decltype(auto) operator>>(F fnc) const {
-    return fnc.template operator()<Vs...>();
+/// Path the loader opened `handle` from, empty if it cannot tell.
+inline std::string library_path(handle_type handle) {
+#if (defined(_WIN32) || defined(_WIN64))
+  char buffer[MAX_PATH];
+  auto length = ::GetModuleFileNameA(handle, buffer, MAX_PATH);
+  return std::string(buffer, length);
+#elif ERL_HAS_ELF_LOOKUP
+  link_map* map = nullptr;
+  if (handle == nullptr || ::dlinfo(handle, RTLD_DI_LINKMAP, &map) != 0 || map == nullptr || map->l_name == nullptr) {
+    return {};
   }
-};
+  return map->l_name;
+#else
+  return {};
+#endif
+}
 
-template <auto... Vs>
-constexpr inline Replicator<Vs...> replicator{};
-}  // namespace impl
+namespace elf {
+constexpr std::uint32_t gnu_hash(std::string_view name) noexcept {
+  std::uint32_t hash = 5381;
+  for (char chr : name) {
+    hash = (hash << 5U) + hash + static_cast<unsigned char>(chr);
+  }
+  return hash;
+}
 
-template <std::ranges::range R>
-consteval auto expand(R const& range) {
-  std::vector<std::meta::info> args;
-  for (auto item : range) {
-    args.push_back(std::meta::reflect_value(item));
+constexpr std::uint32_t sysv_hash(std::string_view name) noexcept {
+  std::uint32_t hash = 0;
+  for (char chr : name) {
+    hash               = (hash << 4U) + static_cast<unsigned char>(chr);
+    std::uint32_t high = hash & 0xf0000000U;
+    if (high != 0) {
+      hash ^= high >> 24U;
+    }
+    hash &= ~high;
   }
-  return substitute(^^impl::replicator, args);
+  return hash;
 }
-}  // namespace meta
-#else
-namespace util {
-template <std::size_t N>
-struct [[nodiscard]] static_string {
-  char value[N + 1]{};
-  constexpr static auto size = N;
 
-  constexpr static_string() = default;
+/// Both ELF hashes of a symbol name, usually computed at compile time.
+struct SymbolHash {
+  std::uint32_t gnu  = 0;
+  std::uint32_t sysv = 0;
+  std::size_t length = 0;
 
-  constexpr explicit(false) static_string(char const (&literal)[N + 1]) {  // NOLINT
-    std::copy(literal, literal + N, std::begin(value));
+  constexpr SymbolHash() = default;
+  constexpr explicit SymbolHash(std::string_view name) noexcept
+      : gnu(gnu_hash(name))
+      , sysv(sysv_hash(name))
+      , length(name.size()) {}
+};
+
+#if ERL_HAS_ELF_LOOKUP
+/// Calls `fnc(dl_phdr_info const&)` with the program headers of the object behind `handle`.
+/// Returns false if the object could not be found.
+template <typename F>
+bool with_program_headers(handle_type handle, F&& fnc) {
+  link_map* map = nullptr;
+  if (handle == nullptr || ::dlinfo(handle, RTLD_DI_LINKMAP, &map) != 0 || map == nullptr) {
+    return false;
   }
 
-  constexpr explicit static_string(std::string_view data) { std::copy(begin(data), end(data), std::begin(value)); }
-  [[nodiscard]] constexpr explicit operator std::string_view() const noexcept { return std::string_view{value}; }
+  struct Search {
+    link_map const* map;
+    F* fnc;
+    bool found;
+  } search{map, &fnc, false};
+
+  ::dl_iterate_phdr(
+      [](dl_phdr_info* info, std::size_t, void* data) -> int {
+        auto& search = *static_cast<Search*>(data);
+        if (info->dlpi_addr != search.map->l_addr) {
+          return 0;
+        }
+
+        // objects can share a load bias (ie. 0 for the executable), the dynamic section tells them apart
+        for (std::size_t idx = 0; idx < info->dlpi_phnum; ++idx) {
+          auto const& header = info->dlpi_phdr[idx];
+          if (header.p_type == PT_DYNAMIC &&
+              info->dlpi_addr + header.p_vaddr == reinterpret_cast<ElfW(Addr)>(search.map->l_ld)) {
+            (*search.fnc)(static_cast<dl_phdr_info const&>(*info));
+            search.found = true;
+            return 1;
+          }
+        }
+        return 0;
+      },
+      &search);
+  return search.found;
+}
+
+/// Lock-free view of the dynamic symbol table of an already loaded object.
+/// Lookups probe `.gnu.hash` (or `.hash` for old objects) directly instead of going through `dlsym`.
+/// Only symbols defined by the object itself are found. TLS and IFUNC symbols are reported as missing, so callers
+/// must fall back to `dlsym` whenever `find` returns `nullptr`.
+class SymbolTable {
+  ElfW(Addr) base                 = 0;
+  ElfW(Sym) const* symbols        = nullptr;
+  char const* strings             = nullptr;
+  std::size_t strings_size        = 0;
+  ElfW(Half) const* versions      = nullptr;
+  std::uint32_t const* gnu_table  = nullptr;
+  std::uint32_t const* sysv_table = nullptr;
+
+  [[nodiscard]] symbol_type accept(std::uint32_t idx, char const* name, std::size_t length) const noexcept {
+    auto const& sym = symbols[idx];
+    if (sym.st_name + length >= strings_size || strings[sym.st_name + length] != '\0' ||
+        std::memcmp(strings + sym.st_name, name, length) != 0) {
+      return nullptr;
+    }
+
+    if (sym.st_shndx == SHN_UNDEF || ELF64_ST_BIND(sym.st_info) == STB_LOCAL) {
+      return nullptr;
+    }
+
+    auto type = ELF64_ST_TYPE(sym.st_info);
+    if (type == STT_TLS || type == STT_GNU_IFUNC || sym.st_value == 0) {
+      return nullptr;
+    }
+
+    // hidden entries are non-default versions which dlsym would not pick either
+    if (versions != nullptr && (versions[idx] & 0x8000U) != 0) {
+      return nullptr;
+    }
+    return reinterpret_cast<symbol_type>(base + sym.st_value);
+  }
+
+  [[nodiscard]] symbol_type find_gnu(char const* name, SymbolHash const& symbol) const noexcept {
+    auto hash         = symbol.gnu;
+    auto bucket_count = gnu_table[0];
+    auto sym_offset   = gnu_table[1];
+    auto bloom_size   = gnu_table[2];
+    auto bloom_shift  = gnu_table[3];
+
+    auto const* bloom   = reinterpret_cast<ElfW(Addr) const*>(gnu_table + 4);
+    auto const* buckets = reinterpret_cast<std::uint32_t const*>(bloom + bloom_size);
+    auto const* chain   = buckets + bucket_count;
+
+    constexpr std::uint32_t word_bits = sizeof(ElfW(Addr)) * 8;
+    auto word                         = bloom[(hash / word_bits) % bloom_size];
+    auto mask = (ElfW(Addr){1} << (hash % word_bits)) | (ElfW(Addr){1} << ((hash >> bloom_shift) % word_bits));
+    if ((word & mask) != mask) {
+      return nullptr;
+    }
+
+    auto idx = buckets[hash % bucket_count];
+    if (idx < sym_offset) {
+      return nullptr;
+    }
+
+    while (true) {
+      auto chain_hash = chain[idx - sym_offset];
+      if ((hash | 1U) == (chain_hash | 1U)) {
+        if (auto addr = accept(idx, name, symbol.length)) {
+          return addr;
+        }
+      }
+      if ((chain_hash & 1U) != 0) {
+        return nullptr;
+      }
+      ++idx;
+    }
+  }
+
+  [[nodiscard]] symbol_type find_sysv(char const* name, SymbolHash const& symbol) const noexcept {
+    auto bucket_count   = sysv_table[0];
+    auto const* buckets = sysv_table + 2;
+    auto const* chain   = buckets + bucket_count;
+
+    for (auto idx = buckets[symbol.sysv % bucket_count]; idx != STN_UNDEF; idx = chain[idx]) {
+      if (auto addr = accept(idx, name, symbol.length)) {
+        return addr;
+      }
+    }
+    return nullptr;
+  }
+
+public:
+  SymbolTable() = default;
+
+  explicit SymbolTable(handle_type handle) noexcept {
+    link_map* map = nullptr;
+    if (handle == nullptr || ::dlinfo(handle, RTLD_DI_LINKMAP, &map) != 0 || map == nullptr) {
+      return;
+    }
+
+    base = map->l_addr;
+    // most targets relocate the dynamic section in place, some (ie. RISC-V, MIPS) keep it read-only
+    auto address = [&](ElfW(Addr) ptr) { return ptr < base ? ptr + base : ptr; };
+    for (auto const* dyn = map->l_ld; dyn != nullptr && dyn->d_tag != DT_NULL; ++dyn) {
+      switch (dyn->d_tag) {
+        case DT_SYMTAB: symbols = reinterpret_cast<ElfW(Sym) const*>(address(dyn->d_un.d_ptr)); break;
+        case DT_STRTAB: strings = reinterpret_cast<char const*>(address(dyn->d_un.d_ptr)); break;
+        case DT_STRSZ: strings_size = dyn->d_un.d_val; break;
+        case DT_VERSYM: versions = reinterpret_cast<ElfW(Half) const*>(address(dyn->d_un.d_ptr)); break;
+        case DT_GNU_HASH: gnu_table = reinterpret_cast<std::uint32_t const*>(address(dyn->d_un.d_ptr)); break;
+        case DT_HASH: sysv_table = reinterpret_cast<std::uint32_t const*>(address(dyn->d_un.d_ptr)); break;
+        default: break;
+      }
+    }
+  }
+
+  [[nodiscard]] bool valid() const noexcept {
+    return symbols != nullptr && strings != nullptr && (gnu_table != nullptr || sysv_table != nullptr);
+  }
+
+  /// Look up a symbol using precomputed hashes. Runtime work is a bucket probe and a `memcmp`.
+  [[nodiscard]] symbol_type find(char const* name, SymbolHash const& symbol) const noexcept {
+    if (!valid()) {
+      return nullptr;
+    }
+    return gnu_table != nullptr ? find_gnu(name, symbol) : find_sysv(name, symbol);
+  }
+
+  [[nodiscard]] symbol_type find(std::string_view name) const noexcept { return find(name.data(), SymbolHash(name)); }
 };
 
-template <std::size_t N>
-static_string(char const (&)[N]) -> static_string<N - 1>;
-}  // namespace util
+/// Maps the ELF file at `path` and calls `fnc(std::span<ElfW(Sym) const>, char const* strings, std::size_t size)` with
+/// its section of `type`, ie. `SHT_SYMTAB` or `SHT_DYNSYM`. The file is never loaded.
+/// Returns false if it is not a native shared object or lacks such a section.
+template <typename F>
+bool with_file_symbols(char const* path, ElfW(Word) type, F&& fnc) {
+  int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat info {};
+  if (::fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < sizeof(ElfW(Ehdr))) {
+    ::close(fd);
+    return false;
+  }
+  auto size     = static_cast<std::size_t>(info.st_size);
+  auto* mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (mapping == MAP_FAILED) {
+    return false;
+  }
 
-namespace reflection {
-#  if __cpp_structured_bindings < 202411L
-namespace arity_impl {
-struct Universal {
-  template <typename T>
-  explicit(false) operator T() const noexcept {
-    static_assert(false, "Universal cannot be used in evaluated contexts");
+  auto const* bytes = static_cast<unsigned char const*>(mapping);
+  auto in_bounds    = [&](std::uint64_t offset, std::uint64_t length) {
+    return offset <= size && length <= size - offset;
+  };
+
+  bool found       = false;
+  auto const* ehdr = reinterpret_cast<ElfW(Ehdr) const*>(bytes);
+  if (std::memcmp(ehdr->e_ident, ELFMAG, SELFMAG) == 0 &&
+      ehdr->e_ident[EI_CLASS] == (sizeof(void*) == 8 ? ELFCLASS64 : ELFCLASS32) && ehdr->e_type == ET_DYN &&
+      ehdr->e_shentsize == sizeof(ElfW(Shdr)) &&
+      in_bounds(ehdr->e_shoff, std::uint64_t{ehdr->e_shnum} * sizeof(ElfW(Shdr)))) {
+    auto const* sections = reinterpret_cast<ElfW(Shdr) const*>(bytes + ehdr->e_shoff);
+    for (std::size_t idx = 0; idx < ehdr->e_shnum && !found; ++idx) {
+      auto const& symtab = sections[idx];
+      if (symtab.sh_type != type || symtab.sh_link >= ehdr->e_shnum || symtab.sh_entsize != sizeof(ElfW(Sym)) ||
+          !in_bounds(symtab.sh_offset, symtab.sh_size)) {
+        continue;
+      }
+      auto const& strtab = sections[symtab.sh_link];
+      if (strtab.sh_size == 0 || !in_bounds(strtab.sh_offset, strtab.sh_size) ||
+          bytes[strtab.sh_offset + strtab.sh_size - 1] != '\0') {
+        continue;
+      }
+
+      fnc(std::span{reinterpret_cast<ElfW(Sym) const*>(bytes + symtab.sh_offset), symtab.sh_size / sizeof(ElfW(Sym))},
+          reinterpret_cast<char const*>(bytes + strtab.sh_offset), static_cast<std::size_t>(strtab.sh_size));
+      found = true;
+    }
   }
+
+  ::munmap(mapping, size);
+  return found;
+}
+
+/// Function containing an address, see `AddressIndex`. Empty if no function covers the address.
+struct AddressInfo {
+  /// Null-terminated, owned by the index.
+  std::string_view name;
+  std::uintptr_t symbol = 0;
+  std::uintptr_t offset = 0;
+
+  [[nodiscard]] explicit operator bool() const noexcept { return !name.empty(); }
 };
 
-template <typename T>
-  requires(std::is_aggregate_v<T>)
-consteval auto compute_arity(auto... parameters) {
-  // this does not work if T has C-array members
-  // however, for the intended use case all members are pointers anyway
-  if constexpr (requires { T{parameters...}; }) {
-    return compute_arity<T>(parameters..., Universal{});
-  } else {
-    return sizeof...(parameters) - 1;
+/// Sorted, immutable address ranges of every function in a loaded object, for profilers and crash handlers.
+/// Built from `.symtab` if the file on disk still has one, from `.dynsym` otherwise, so local functions are named
+/// as long as the object is not stripped. Lookups are a binary search which neither locks nor allocates and, unlike
+/// `dladdr`, is async-signal-safe. The index must outlive every concurrent lookup.
+class AddressIndex {
+  struct Range {
+    std::uintptr_t begin;
+    std::uintptr_t end;
+    std::size_t name;
+    std::size_t length;
+  };
+
+  std::vector<Range> ranges;
+  std::string names;
+
+  [[nodiscard]] AddressInfo describe(Range const& range, std::uintptr_t address) const noexcept {
+    return {std::string_view{names.data() + range.name, range.length}, range.begin, address - range.begin};
+  }
+
+  [[nodiscard]] Range const* find(std::uintptr_t address) const noexcept {
+    auto it = std::upper_bound(ranges.begin(), ranges.end(), address,
+                               [](std::uintptr_t value, Range const& range) { return value < range.begin; });
+    if (it == ranges.begin() || address >= std::prev(it)->end) {
+      return nullptr;
+    }
+    return &*std::prev(it);
+  }
+
+public:
+  AddressIndex() = default;
+
+  explicit AddressIndex(handle_type handle) {
+    link_map* map = nullptr;
+    if (handle == nullptr || ::dlinfo(handle, RTLD_DI_LINKMAP, &map) != 0 || map == nullptr ||
+        map->l_name == nullptr || map->l_name[0] == '\0') {
+      return;
+    }
+
+    auto collect = [&](std::span<ElfW(Sym) const> symbols, char const* strings, std::size_t strings_size) {
+      for (auto const& sym : symbols) {
+        auto type = ELF64_ST_TYPE(sym.st_info);
+        if ((type != STT_FUNC && type != STT_GNU_IFUNC) || sym.st_shndx == SHN_UNDEF || sym.st_size == 0 ||
+            sym.st_name >= strings_size || strings[sym.st_name] == '\0') {
+          continue;
+        }
+        auto name = std::string_view{strings + sym.st_name};
+        ranges.push_back({map->l_addr + sym.st_value, map->l_addr + sym.st_value + sym.st_size, names.size(),
+                          name.size()});
+        names.append(name);
+        names.push_back('\0');
+      }
+    };
+    if (!with_file_symbols(map->l_name, SHT_SYMTAB, collect)) {
+      with_file_symbols(map->l_name, SHT_DYNSYM, collect);
+    }
+
+    // aliases share an address, the first one after sorting wins
+    std::ranges::stable_sort(ranges, {}, &Range::begin);
+    auto duplicates = std::ranges::unique(ranges, {}, &Range::begin);
+    ranges.erase(duplicates.begin(), duplicates.end());
+    ranges.shrink_to_fit();
+    names.shrink_to_fit();
   }
+
+  [[nodiscard]] std::size_t size() const noexcept { return ranges.size(); }
+  [[nodiscard]] bool empty() const noexcept { return ranges.empty(); }
+
+  /// Async-signal-safe.
+  [[nodiscard]] AddressInfo lookup(std::uintptr_t address) const noexcept {
+    auto const* range = find(address);
+    return range == nullptr ? AddressInfo{} : describe(*range, address);
+  }
+
+  [[nodiscard]] AddressInfo lookup(void const* address) const noexcept {
+    return lookup(reinterpret_cast<std::uintptr_t>(address));
+  }
+
+  /// Resolves a batch of addresses, ie. one stack sample, into `out` which must be at least as large.
+  /// Consecutive addresses within the same function only search once. Async-signal-safe.
+  void symbolize(std::span<void const* const> addresses, std::span<AddressInfo> out) const noexcept {
+    Range const* last = nullptr;
+    for (std::size_t idx = 0; idx < addresses.size() && idx < out.size(); ++idx) {
+      auto address = reinterpret_cast<std::uintptr_t>(addresses[idx]);
+      if (last == nullptr || address < last->begin || address >= last->end) {
+        last = find(address);
+      }
+      out[idx] = last == nullptr ? AddressInfo{} : describe(*last, address);
+    }
+  }
+};
+#endif
+}  // namespace elf
+
+/// Copies `size` bytes from `data` to `offset` within fresh pages of their own and makes those read-only.
+/// Returns the copy, or `nullptr` if no pages could be mapped. Release it with `unmap_read_only`.
+inline void const* map_read_only(void const* data, std::size_t size, std::size_t offset) noexcept {
+#if (defined(_WIN32) || defined(_WIN64))
+  auto* pages = static_cast<unsigned char*>(::VirtualAlloc(nullptr, offset + size, MEM_RESERVE | MEM_COMMIT,
+                                                           PAGE_READWRITE));
+  if (pages == nullptr) {
+    return nullptr;
+  }
+  std::memcpy(pages + offset, data, size);
+  DWORD previous = 0;
+  ::VirtualProtect(pages, offset + size, PAGE_READONLY, &previous);
+#else
+  void* mapping = ::mmap(nullptr, offset + size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (mapping == MAP_FAILED) {
+    return nullptr;
+  }
+  auto* pages = static_cast<unsigned char*>(mapping);
+  std::memcpy(pages + offset, data, size);
+  ::mprotect(mapping, offset + size, PROT_READ);
+#endif
+  return pages + offset;
 }
-}  // namespace arity_impl
 
-template <typename T>
-  requires std::is_aggregate_v<T>
-inline constexpr std::size_t arity = arity_impl::compute_arity<T>();
+inline void unmap_read_only(void const* copy, [[maybe_unused]] std::size_t size, std::size_t offset) noexcept {
+  auto* pages = const_cast<unsigned char*>(static_cast<unsigned char const*>(copy)) - offset;
+#if (defined(_WIN32) || defined(_WIN64))
+  ::VirtualFree(pages, 0, MEM_RELEASE);
+#else
+  ::munmap(pages, offset + size);
+#endif
+}
 
-namespace visit_impl {
-template <typename T, typename V>
-  requires(std::is_aggregate_v<std::remove_cvref_t<T> > && !std::is_array_v<std::remove_cvref_t<T> >)
-constexpr auto visit_aggregate(V visitor, T&& object) {
-  constexpr auto member_count = arity<std::remove_cvref_t<T> >;
-  // this is generated
-  if constexpr (member_count == 0) {
-    return visitor();
-  } else if constexpr (member_count == 1) {
-    auto& [member_0] = object;
-    return visitor(member_0);
-  } else if constexpr (member_count == 2) {
-    auto& [member_0, member_1] = object;
+/// Bytes covered by `prefault`, in whole pages.
+struct PrefaultReport {
+  std::size_t bytes  = 0;
+  std::size_t locked = 0;
+};
+
+#if ERL_HAS_ELF_LOOKUP
+/// Reads in every loadable segment of the object behind `handle`, so first calls into it do not take page faults.
+/// With `lock` the segments are also `mlock`ed. Locking is subject to RLIMIT_MEMLOCK and skipped if it is denied.
+inline PrefaultReport prefault(handle_type handle, bool lock = false) noexcept {
+  PrefaultReport report;
+  auto page = static_cast<std::uintptr_t>(::sysconf(_SC_PAGESIZE));
+  elf::with_program_headers(handle, [&](dl_phdr_info const& info) {
+    for (std::size_t idx = 0; idx < info.dlpi_phnum; ++idx) {
+      auto const& header = info.dlpi_phdr[idx];
+      if (header.p_type != PT_LOAD || (header.p_flags & PF_R) == 0 || header.p_memsz == 0) {
+        continue;
+      }
+
+      auto begin  = (info.dlpi_addr + header.p_vaddr) & ~(page - 1);
+      auto end    = (info.dlpi_addr + header.p_vaddr + header.p_memsz + page - 1) & ~(page - 1);
+      auto* start = reinterpret_cast<void*>(begin);
+
+      // read-ahead for the whole segment first, touching the pages then only maps what is already cached
+      ::madvise(start, end - begin, MADV_WILLNEED);
+      for (auto address = begin; address < end; address += page) {
+        (void)*reinterpret_cast<unsigned char const volatile*>(address);
+      }
+      report.bytes += end - begin;
+
+      if (lock && ::mlock(start, end - begin) == 0) {
+        report.locked += end - begin;
+      }
+    }
+  });
+  return report;
+}
+#endif
+
+#if ERL_HAS_ELF_LOOKUP
+namespace _impl {
+inline constexpr std::uintptr_t huge_page_size = std::uintptr_t{2} << 20U;
+
+inline bool transparent_huge_pages() noexcept {
+  int fd = ::open("/sys/kernel/mm/transparent_hugepage/enabled", O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return false;
+  }
+  char mode[64]{};
+  auto size = ::read(fd, mode, sizeof(mode) - 1);
+  ::close(fd);
+
+  auto selected = std::string_view{mode, size > 0 ? static_cast<std::size_t>(size) : 0U};
+  return selected.find("[always]") != std::string_view::npos || selected.find("[madvise]") != std::string_view::npos;
+}
+
+// copies [target, target + size) into a huge page backed region and moves that over the original in one step
+inline bool move_to_huge_pages(std::uintptr_t target, std::size_t size, int protection) noexcept {
+  auto reserved = size + huge_page_size;
+  void* raw     = ::mmap(nullptr, reserved, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (raw == MAP_FAILED) {
+    return false;
+  }
+
+  auto first = reinterpret_cast<std::uintptr_t>(raw);
+  auto start = (first + huge_page_size - 1) & ~(huge_page_size - 1);
+  if (start != first) {
+    ::munmap(raw, start - first);
+  }
+  if (first + reserved != start + size) {
+    ::munmap(reinterpret_cast<void*>(start + size), first + reserved - start - size);
+  }
+
+  auto* region = reinterpret_cast<char*>(start);
+  if (::madvise(region, size, MADV_HUGEPAGE) != 0) {
+    ::munmap(region, size);
+    return false;
+  }
+
+  std::memcpy(region, reinterpret_cast<void const*>(target), size);
+  __builtin___clear_cache(region, region + size);
+
+  // hardened kernels refuse executable anonymous memory, the original mapping stays in place then
+  if (::mprotect(region, size, protection) != 0 ||
+      ::mremap(region, size, size, MREMAP_MAYMOVE | MREMAP_FIXED, reinterpret_cast<void*>(target)) == MAP_FAILED) {
+    ::munmap(region, size);
+    return false;
+  }
+  return true;
+}
+}  // namespace _impl
+
+/// Moves the 2 MiB aligned part of every executable segment onto transparent huge pages to cut iTLB misses.
+/// The copy replaces the original mapping in a single `mremap`, so threads already running code of the library see
+/// identical instructions throughout. Returns the bytes moved, 0 if the segments are too small, transparent huge
+/// pages are disabled or the system refuses executable anonymous memory.
+/// Profilers and debuggers no longer see the file behind the moved text.
+inline std::size_t remap_text_to_huge_pages(handle_type handle) noexcept {
+  if (!_impl::transparent_huge_pages()) {
+    return 0;
+  }
+
+  std::size_t moved = 0;
+  elf::with_program_headers(handle, [&](dl_phdr_info const& info) {
+    for (std::size_t idx = 0; idx < info.dlpi_phnum; ++idx) {
+      auto const& header = info.dlpi_phdr[idx];
+      if (header.p_type != PT_LOAD || (header.p_flags & PF_X) == 0 || (header.p_flags & PF_R) == 0) {
+        continue;
+      }
+
+      auto begin = (info.dlpi_addr + header.p_vaddr + _impl::huge_page_size - 1) & ~(_impl::huge_page_size - 1);
+      auto end   = (info.dlpi_addr + header.p_vaddr + header.p_filesz) & ~(_impl::huge_page_size - 1);
+      auto protection = PROT_READ | PROT_EXEC | ((header.p_flags & PF_W) != 0 ? PROT_WRITE : 0);
+      if (begin < end && _impl::move_to_huge_pages(begin, end - begin, protection)) {
+        moved += end - begin;
+      }
+    }
+  });
+  return moved;
+}
+#endif
+
+/// Resolves many symbols from one handle.
+/// Uses a direct ELF hash table lookup where available and falls back to `get_symbol` otherwise.
+class SymbolResolver {
+  handle_type handle;
+#if ERL_HAS_ELF_LOOKUP
+  elf::SymbolTable table;
+#endif
+
+public:
+  explicit SymbolResolver(handle_type handle)
+      : handle(handle)
+#if ERL_HAS_ELF_LOOKUP
+      , table(handle)
+#endif
+  {
+  }
+
+  symbol_type operator()(char const* name) const { return (*this)(name, elf::SymbolHash(name)); }
+
+  symbol_type operator()(char const* name, [[maybe_unused]] elf::SymbolHash const& hash) const {
+#if ERL_HAS_ELF_LOOKUP
+    if (auto addr = table.find(name, hash)) {
+      return addr;
+    }
+#endif
+    return get_symbol(handle, name);
+  }
+
+  /// Returns `nullptr` for missing symbols instead of throwing.
+  /// `local`, if given, is set when the object's own table had the symbol rather than the loader's search.
+  symbol_type find(char const* name, [[maybe_unused]] elf::SymbolHash const& hash,
+                   bool* local = nullptr) const noexcept {
+#if ERL_HAS_ELF_LOOKUP
+    if (auto addr = table.find(name, hash)) {
+      if (local != nullptr) {
+        *local = true;
+      }
+      return addr;
+    }
+#endif
+    return find_symbol(handle, name);
+  }
+
+  /// Only searches the object's own symbol table, where misses are cheap. Always `nullptr` without ELF lookup.
+  symbol_type find_local([[maybe_unused]] char const* name,
+                         [[maybe_unused]] elf::SymbolHash const& hash) const noexcept {
+#if ERL_HAS_ELF_LOOKUP
+    return table.find(name, hash);
+#else
+    return nullptr;
+#endif
+  }
+};
+
+}  // namespace platform
+
+namespace util {
+template <std::size_t N>
+struct [[nodiscard]] static_string {
+  char value[N + 1]{};
+  constexpr static auto size = N;
+
+  constexpr static_string() = default;
+
+  constexpr explicit(false) static_string(char const (&literal)[N + 1]) {  // NOLINT
+    std::copy(literal, literal + N, std::begin(value));
+  }
+
+  constexpr explicit static_string(std::string_view data) { std::copy(begin(data), end(data), std::begin(value)); }
+  [[nodiscard]] constexpr explicit operator std::string_view() const noexcept { return std::string_view{value, N}; }
+  [[nodiscard]] constexpr char const* c_str() const noexcept { return value; }
+};
+
+template <std::size_t N>
+static_string(char const (&)[N]) -> static_string<N - 1>;
+}  // namespace util
+
+#if ERL_HAS_REFLECTION
+namespace meta {
+namespace impl {
+template <auto... Vs>
+struct Replicator {
+  template <typename F>
+  constexpr decltype(auto) operator>>(F fnc) const {
+    return fnc.template operator()<Vs...>();
+  }
+};
+
+template <auto... Vs>
+constexpr inline Replicator<Vs...> replicator{};
+}  // namespace impl
+
+template <std::ranges::range R>
+consteval auto expand(R const& range) {
+  std::vector<std::meta::info> args;
+  for (auto item : range) {
+    args.push_back(std::meta::reflect_value(item));
+  }
+  return substitute(^^impl::replicator, args);
+}
+}  // namespace meta
+#else
+namespace reflection {
+#  if __cpp_structured_bindings < 202411L
+namespace arity_impl {
+struct Universal {
+  template <typename T>
+  explicit(false) operator T() const noexcept {
+    static_assert(sizeof(T) == 0, "Universal cannot be used in evaluated contexts");
+  }
+};
+
+template <std::size_t>
+using universal = Universal;
+
+template <typename T, std::size_t N>
+inline constexpr bool constructible_with = []<std::size_t... Idx>(std::index_sequence<Idx...>) {
+  return requires { T{universal<Idx>{}...}; };
+}(std::make_index_sequence<N>{});
+
+// T is constructible from Low initializers but not from High
+template <typename T, std::size_t Low, std::size_t High>
+consteval std::size_t search_arity() {
+  if constexpr (High - Low <= 1) {
+    return Low;
+  } else if constexpr (constexpr std::size_t mid = Low + (High - Low) / 2; constructible_with<T, mid>) {
+    return search_arity<T, mid, High>();
+  } else {
+    return search_arity<T, Low, mid>();
+  }
+}
+
+// doubles the bound until construction fails, then bisects. Probing one initializer at a time instead costs a
+// quadratic number of template arguments for large Wrappers
+// this does not work if T has C-array members
+// however, for the intended use case all members are pointers anyway
+template <typename T, std::size_t Bound = 1>
+  requires(std::is_aggregate_v<T>)
+consteval std::size_t compute_arity() {
+  if constexpr (constructible_with<T, Bound>) {
+    return compute_arity<T, Bound * 2>();
+  } else {
+    return search_arity<T, Bound / 2, Bound>();
+  }
+}
+}  // namespace arity_impl
+
+template <typename T>
+  requires std::is_aggregate_v<T>
+inline constexpr std::size_t arity = arity_impl::compute_arity<T>();
+
+namespace visit_impl {
+// one specialization per member count, so visiting a Wrapper instantiates exactly one of them
+// this is generated
+template <std::size_t N>
+struct Visitor {
+  static_assert(N <= 64, "aggregates with more than 64 members require structured binding packs");
+};
+
+template <>
+struct Visitor<0> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, [[maybe_unused]] T& object) {
+    return visitor();
+  }
+};
+
+template <>
+struct Visitor<1> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
+    auto& [member_0] = object;
+    return visitor(member_0);
+  }
+};
+
+template <>
+struct Visitor<2> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
+    auto& [member_0, member_1] = object;
     return visitor(member_0, member_1);
-  } else if constexpr (member_count == 3) {
+  }
+};
+
+template <>
+struct Visitor<3> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2] = object;
     return visitor(member_0, member_1, member_2);
-  } else if constexpr (member_count == 4) {
+  }
+};
+
+template <>
+struct Visitor<4> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3] = object;
     return visitor(member_0, member_1, member_2, member_3);
-  } else if constexpr (member_count == 5) {
+  }
+};
+
+template <>
+struct Visitor<5> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3, member_4] = object;
     return visitor(member_0, member_1, member_2, member_3, member_4);
-  } else if constexpr (member_count == 6) {
+  }
+};
+
+template <>
+struct Visitor<6> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3, member_4, member_5] = object;
     return visitor(member_0, member_1, member_2, member_3, member_4, member_5);
-  } else if constexpr (member_count == 7) {
+  }
+};
+
+template <>
+struct Visitor<7> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3, member_4, member_5, member_6] = object;
     return visitor(member_0, member_1, member_2, member_3, member_4, member_5, member_6);
-  } else if constexpr (member_count == 8) {
+  }
+};
+
+template <>
+struct Visitor<8> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7] = object;
     return visitor(member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7);
-  } else if constexpr (member_count == 9) {
+  }
+};
+
+template <>
+struct Visitor<9> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8] = object;
     return visitor(member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8);
-  } else if constexpr (member_count == 10) {
+  }
+};
+
+template <>
+struct Visitor<10> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9] = object;
     return visitor(member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9);
-  } else if constexpr (member_count == 11) {
+  }
+};
+
+template <>
+struct Visitor<11> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
            member_10] = object;
     return visitor(member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
                    member_10);
-  } else if constexpr (member_count == 12) {
+  }
+};
+
+template <>
+struct Visitor<12> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
            member_10, member_11] = object;
     return visitor(member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
                    member_10, member_11);
-  } else if constexpr (member_count == 13) {
+  }
+};
+
+template <>
+struct Visitor<13> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
            member_10, member_11, member_12] = object;
     return visitor(member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
                    member_10, member_11, member_12);
-  } else if constexpr (member_count == 14) {
+  }
+};
+
+template <>
+struct Visitor<14> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
            member_10, member_11, member_12, member_13] = object;
     return visitor(member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
                    member_10, member_11, member_12, member_13);
-  } else if constexpr (member_count == 15) {
+  }
+};
+
+template <>
+struct Visitor<15> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
            member_10, member_11, member_12, member_13, member_14] = object;
     return visitor(member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
                    member_10, member_11, member_12, member_13, member_14);
-  } else if constexpr (member_count == 16) {
+  }
+};
+
+template <>
+struct Visitor<16> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
            member_10, member_11, member_12, member_13, member_14, member_15] = object;
     return visitor(member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
                    member_10, member_11, member_12, member_13, member_14, member_15);
-  } else if constexpr (member_count == 17) {
+  }
+};
+
+template <>
+struct Visitor<17> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
            member_10, member_11, member_12, member_13, member_14, member_15, member_16] = object;
     return visitor(member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
                    member_10, member_11, member_12, member_13, member_14, member_15, member_16);
-  } else if constexpr (member_count == 18) {
+  }
+};
+
+template <>
+struct Visitor<18> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
            member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17] = object;
     return visitor(member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
                    member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17);
-  } else if constexpr (member_count == 19) {
+  }
+};
+
+template <>
+struct Visitor<19> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
            member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18] = object;
     return visitor(member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
                    member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18);
-  } else if constexpr (member_count == 20) {
+  }
+};
+
+template <>
+struct Visitor<20> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
            member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18,
            member_19] = object;
     return visitor(member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
                    member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18,
                    member_19);
-  } else if constexpr (member_count == 21) {
+  }
+};
+
+template <>
+struct Visitor<21> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
            member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18, member_19,
            member_20] = object;
     return visitor(member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
                    member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18,
                    member_19, member_20);
-  } else if constexpr (member_count == 22) {
+  }
+};
+
+template <>
+struct Visitor<22> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
            member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18, member_19,
            member_20, member_21] = object;
     return visitor(member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
                    member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18,
                    member_19, member_20, member_21);
-  } else if constexpr (member_count == 23) {
+  }
+};
+
+template <>
+struct Visitor<23> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
            member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18, member_19,
            member_20, member_21, member_22] = object;
     return visitor(member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
                    member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18,
                    member_19, member_20, member_21, member_22);
-  } else if constexpr (member_count == 24) {
+  }
+};
+
+template <>
+struct Visitor<24> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
            member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18, member_19,
            member_20, member_21, member_22, member_23] = object;
     return visitor(member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
                    member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18,
                    member_19, member_20, member_21, member_22, member_23);
-  } else if constexpr (member_count == 25) {
+  }
+};
+
+template <>
+struct Visitor<25> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
            member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18, member_19,
            member_20, member_21, member_22, member_23, member_24] = object;
     return visitor(member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
                    member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18,
                    member_19, member_20, member_21, member_22, member_23, member_24);
-  } else if constexpr (member_count == 26) {
+  }
+};
+
+template <>
+struct Visitor<26> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
            member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18, member_19,
            member_20, member_21, member_22, member_23, member_24, member_25] = object;
     return visitor(member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
                    member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18,
                    member_19, member_20, member_21, member_22, member_23, member_24, member_25);
-  } else if constexpr (member_count == 27) {
+  }
+};
+
+template <>
+struct Visitor<27> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
            member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18, member_19,
            member_20, member_21, member_22, member_23, member_24, member_25, member_26] = object;
     return visitor(member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
                    member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18,
                    member_19, member_20, member_21, member_22, member_23, member_24, member_25, member_26);
-  } else if constexpr (member_count == 28) {
+  }
+};
+
+template <>
+struct Visitor<28> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
            member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18, member_19,
            member_20, member_21, member_22, member_23, member_24, member_25, member_26, member_27] = object;
     return visitor(member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
                    member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18,
                    member_19, member_20, member_21, member_22, member_23, member_24, member_25, member_26, member_27);
-  } else if constexpr (member_count == 29) {
+  }
+};
+
+template <>
+struct Visitor<29> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
            member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18, member_19,
            member_20, member_21, member_22, member_23, member_24, member_25, member_26, member_27, member_28] = object;
@@ -370,7 +1487,13 @@ constexpr auto visit_aggregate(V visitor, T&& object) {
                    member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18,
                    member_19, member_20, member_21, member_22, member_23, member_24, member_25, member_26, member_27,
                    member_28);
-  } else if constexpr (member_count == 30) {
+  }
+};
+
+template <>
+struct Visitor<30> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
            member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18, member_19,
            member_20, member_21, member_22, member_23, member_24, member_25, member_26, member_27, member_28,
@@ -379,7 +1502,13 @@ constexpr auto visit_aggregate(V visitor, T&& object) {
                    member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18,
                    member_19, member_20, member_21, member_22, member_23, member_24, member_25, member_26, member_27,
                    member_28, member_29);
-  } else if constexpr (member_count == 31) {
+  }
+};
+
+template <>
+struct Visitor<31> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
            member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18, member_19,
            member_20, member_21, member_22, member_23, member_24, member_25, member_26, member_27, member_28, member_29,
@@ -388,7 +1517,13 @@ constexpr auto visit_aggregate(V visitor, T&& object) {
                    member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18,
                    member_19, member_20, member_21, member_22, member_23, member_24, member_25, member_26, member_27,
                    member_28, member_29, member_30);
-  } else if constexpr (member_count == 32) {
+  }
+};
+
+template <>
+struct Visitor<32> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
            member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18, member_19,
            member_20, member_21, member_22, member_23, member_24, member_25, member_26, member_27, member_28, member_29,
@@ -397,7 +1532,13 @@ constexpr auto visit_aggregate(V visitor, T&& object) {
                    member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18,
                    member_19, member_20, member_21, member_22, member_23, member_24, member_25, member_26, member_27,
                    member_28, member_29, member_30, member_31);
-  } else if constexpr (member_count == 33) {
+  }
+};
+
+template <>
+struct Visitor<33> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
            member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18, member_19,
            member_20, member_21, member_22, member_23, member_24, member_25, member_26, member_27, member_28, member_29,
@@ -406,7 +1547,13 @@ constexpr auto visit_aggregate(V visitor, T&& object) {
                    member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18,
                    member_19, member_20, member_21, member_22, member_23, member_24, member_25, member_26, member_27,
                    member_28, member_29, member_30, member_31, member_32);
-  } else if constexpr (member_count == 34) {
+  }
+};
+
+template <>
+struct Visitor<34> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
            member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18, member_19,
            member_20, member_21, member_22, member_23, member_24, member_25, member_26, member_27, member_28, member_29,
@@ -415,7 +1562,13 @@ constexpr auto visit_aggregate(V visitor, T&& object) {
                    member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18,
                    member_19, member_20, member_21, member_22, member_23, member_24, member_25, member_26, member_27,
                    member_28, member_29, member_30, member_31, member_32, member_33);
-  } else if constexpr (member_count == 35) {
+  }
+};
+
+template <>
+struct Visitor<35> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
            member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18, member_19,
            member_20, member_21, member_22, member_23, member_24, member_25, member_26, member_27, member_28, member_29,
@@ -424,7 +1577,13 @@ constexpr auto visit_aggregate(V visitor, T&& object) {
                    member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18,
                    member_19, member_20, member_21, member_22, member_23, member_24, member_25, member_26, member_27,
                    member_28, member_29, member_30, member_31, member_32, member_33, member_34);
-  } else if constexpr (member_count == 36) {
+  }
+};
+
+template <>
+struct Visitor<36> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
            member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18, member_19,
            member_20, member_21, member_22, member_23, member_24, member_25, member_26, member_27, member_28, member_29,
@@ -433,7 +1592,13 @@ constexpr auto visit_aggregate(V visitor, T&& object) {
                    member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18,
                    member_19, member_20, member_21, member_22, member_23, member_24, member_25, member_26, member_27,
                    member_28, member_29, member_30, member_31, member_32, member_33, member_34, member_35);
-  } else if constexpr (member_count == 37) {
+  }
+};
+
+template <>
+struct Visitor<37> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
            member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18, member_19,
            member_20, member_21, member_22, member_23, member_24, member_25, member_26, member_27, member_28, member_29,
@@ -442,7 +1607,13 @@ constexpr auto visit_aggregate(V visitor, T&& object) {
                    member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18,
                    member_19, member_20, member_21, member_22, member_23, member_24, member_25, member_26, member_27,
                    member_28, member_29, member_30, member_31, member_32, member_33, member_34, member_35, member_36);
-  } else if constexpr (member_count == 38) {
+  }
+};
+
+template <>
+struct Visitor<38> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
            member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18, member_19,
            member_20, member_21, member_22, member_23, member_24, member_25, member_26, member_27, member_28, member_29,
@@ -452,7 +1623,13 @@ constexpr auto visit_aggregate(V visitor, T&& object) {
                    member_19, member_20, member_21, member_22, member_23, member_24, member_25, member_26, member_27,
                    member_28, member_29, member_30, member_31, member_32, member_33, member_34, member_35, member_36,
                    member_37);
-  } else if constexpr (member_count == 39) {
+  }
+};
+
+template <>
+struct Visitor<39> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
            member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18, member_19,
            member_20, member_21, member_22, member_23, member_24, member_25, member_26, member_27, member_28, member_29,
@@ -462,7 +1639,13 @@ constexpr auto visit_aggregate(V visitor, T&& object) {
                    member_19, member_20, member_21, member_22, member_23, member_24, member_25, member_26, member_27,
                    member_28, member_29, member_30, member_31, member_32, member_33, member_34, member_35, member_36,
                    member_37, member_38);
-  } else if constexpr (member_count == 40) {
+  }
+};
+
+template <>
+struct Visitor<40> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
            member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18, member_19,
            member_20, member_21, member_22, member_23, member_24, member_25, member_26, member_27, member_28, member_29,
@@ -473,7 +1656,13 @@ constexpr auto visit_aggregate(V visitor, T&& object) {
                    member_19, member_20, member_21, member_22, member_23, member_24, member_25, member_26, member_27,
                    member_28, member_29, member_30, member_31, member_32, member_33, member_34, member_35, member_36,
                    member_37, member_38, member_39);
-  } else if constexpr (member_count == 41) {
+  }
+};
+
+template <>
+struct Visitor<41> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
            member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18, member_19,
            member_20, member_21, member_22, member_23, member_24, member_25, member_26, member_27, member_28, member_29,
@@ -484,7 +1673,13 @@ constexpr auto visit_aggregate(V visitor, T&& object) {
                    member_19, member_20, member_21, member_22, member_23, member_24, member_25, member_26, member_27,
                    member_28, member_29, member_30, member_31, member_32, member_33, member_34, member_35, member_36,
                    member_37, member_38, member_39, member_40);
-  } else if constexpr (member_count == 42) {
+  }
+};
+
+template <>
+struct Visitor<42> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
            member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18, member_19,
            member_20, member_21, member_22, member_23, member_24, member_25, member_26, member_27, member_28, member_29,
@@ -495,7 +1690,13 @@ constexpr auto visit_aggregate(V visitor, T&& object) {
                    member_19, member_20, member_21, member_22, member_23, member_24, member_25, member_26, member_27,
                    member_28, member_29, member_30, member_31, member_32, member_33, member_34, member_35, member_36,
                    member_37, member_38, member_39, member_40, member_41);
-  } else if constexpr (member_count == 43) {
+  }
+};
+
+template <>
+struct Visitor<43> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
            member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18, member_19,
            member_20, member_21, member_22, member_23, member_24, member_25, member_26, member_27, member_28, member_29,
@@ -506,7 +1707,13 @@ constexpr auto visit_aggregate(V visitor, T&& object) {
                    member_19, member_20, member_21, member_22, member_23, member_24, member_25, member_26, member_27,
                    member_28, member_29, member_30, member_31, member_32, member_33, member_34, member_35, member_36,
                    member_37, member_38, member_39, member_40, member_41, member_42);
-  } else if constexpr (member_count == 44) {
+  }
+};
+
+template <>
+struct Visitor<44> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
            member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18, member_19,
            member_20, member_21, member_22, member_23, member_24, member_25, member_26, member_27, member_28, member_29,
@@ -517,7 +1724,13 @@ constexpr auto visit_aggregate(V visitor, T&& object) {
                    member_19, member_20, member_21, member_22, member_23, member_24, member_25, member_26, member_27,
                    member_28, member_29, member_30, member_31, member_32, member_33, member_34, member_35, member_36,
                    member_37, member_38, member_39, member_40, member_41, member_42, member_43);
-  } else if constexpr (member_count == 45) {
+  }
+};
+
+template <>
+struct Visitor<45> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
            member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18, member_19,
            member_20, member_21, member_22, member_23, member_24, member_25, member_26, member_27, member_28, member_29,
@@ -528,7 +1741,13 @@ constexpr auto visit_aggregate(V visitor, T&& object) {
                    member_19, member_20, member_21, member_22, member_23, member_24, member_25, member_26, member_27,
                    member_28, member_29, member_30, member_31, member_32, member_33, member_34, member_35, member_36,
                    member_37, member_38, member_39, member_40, member_41, member_42, member_43, member_44);
-  } else if constexpr (member_count == 46) {
+  }
+};
+
+template <>
+struct Visitor<46> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
            member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18, member_19,
            member_20, member_21, member_22, member_23, member_24, member_25, member_26, member_27, member_28, member_29,
@@ -539,7 +1758,13 @@ constexpr auto visit_aggregate(V visitor, T&& object) {
                    member_19, member_20, member_21, member_22, member_23, member_24, member_25, member_26, member_27,
                    member_28, member_29, member_30, member_31, member_32, member_33, member_34, member_35, member_36,
                    member_37, member_38, member_39, member_40, member_41, member_42, member_43, member_44, member_45);
-  } else if constexpr (member_count == 47) {
+  }
+};
+
+template <>
+struct Visitor<47> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
            member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18, member_19,
            member_20, member_21, member_22, member_23, member_24, member_25, member_26, member_27, member_28, member_29,
@@ -551,7 +1776,13 @@ constexpr auto visit_aggregate(V visitor, T&& object) {
                    member_28, member_29, member_30, member_31, member_32, member_33, member_34, member_35, member_36,
                    member_37, member_38, member_39, member_40, member_41, member_42, member_43, member_44, member_45,
                    member_46);
-  } else if constexpr (member_count == 48) {
+  }
+};
+
+template <>
+struct Visitor<48> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
            member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18, member_19,
            member_20, member_21, member_22, member_23, member_24, member_25, member_26, member_27, member_28, member_29,
@@ -563,7 +1794,13 @@ constexpr auto visit_aggregate(V visitor, T&& object) {
                    member_28, member_29, member_30, member_31, member_32, member_33, member_34, member_35, member_36,
                    member_37, member_38, member_39, member_40, member_41, member_42, member_43, member_44, member_45,
                    member_46, member_47);
-  } else if constexpr (member_count == 49) {
+  }
+};
+
+template <>
+struct Visitor<49> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
            member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18, member_19,
            member_20, member_21, member_22, member_23, member_24, member_25, member_26, member_27, member_28, member_29,
@@ -575,7 +1812,13 @@ constexpr auto visit_aggregate(V visitor, T&& object) {
                    member_28, member_29, member_30, member_31, member_32, member_33, member_34, member_35, member_36,
                    member_37, member_38, member_39, member_40, member_41, member_42, member_43, member_44, member_45,
                    member_46, member_47, member_48);
-  } else if constexpr (member_count == 50) {
+  }
+};
+
+template <>
+struct Visitor<50> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
            member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18, member_19,
            member_20, member_21, member_22, member_23, member_24, member_25, member_26, member_27, member_28, member_29,
@@ -588,7 +1831,13 @@ constexpr auto visit_aggregate(V visitor, T&& object) {
                    member_28, member_29, member_30, member_31, member_32, member_33, member_34, member_35, member_36,
                    member_37, member_38, member_39, member_40, member_41, member_42, member_43, member_44, member_45,
                    member_46, member_47, member_48, member_49);
-  } else if constexpr (member_count == 51) {
+  }
+};
+
+template <>
+struct Visitor<51> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
            member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18, member_19,
            member_20, member_21, member_22, member_23, member_24, member_25, member_26, member_27, member_28, member_29,
@@ -601,7 +1850,13 @@ constexpr auto visit_aggregate(V visitor, T&& object) {
                    member_28, member_29, member_30, member_31, member_32, member_33, member_34, member_35, member_36,
                    member_37, member_38, member_39, member_40, member_41, member_42, member_43, member_44, member_45,
                    member_46, member_47, member_48, member_49, member_50);
-  } else if constexpr (member_count == 52) {
+  }
+};
+
+template <>
+struct Visitor<52> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
            member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18, member_19,
            member_20, member_21, member_22, member_23, member_24, member_25, member_26, member_27, member_28, member_29,
@@ -614,7 +1869,13 @@ constexpr auto visit_aggregate(V visitor, T&& object) {
                    member_28, member_29, member_30, member_31, member_32, member_33, member_34, member_35, member_36,
                    member_37, member_38, member_39, member_40, member_41, member_42, member_43, member_44, member_45,
                    member_46, member_47, member_48, member_49, member_50, member_51);
-  } else if constexpr (member_count == 53) {
+  }
+};
+
+template <>
+struct Visitor<53> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
            member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18, member_19,
            member_20, member_21, member_22, member_23, member_24, member_25, member_26, member_27, member_28, member_29,
@@ -627,7 +1888,13 @@ constexpr auto visit_aggregate(V visitor, T&& object) {
                    member_28, member_29, member_30, member_31, member_32, member_33, member_34, member_35, member_36,
                    member_37, member_38, member_39, member_40, member_41, member_42, member_43, member_44, member_45,
                    member_46, member_47, member_48, member_49, member_50, member_51, member_52);
-  } else if constexpr (member_count == 54) {
+  }
+};
+
+template <>
+struct Visitor<54> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
            member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18, member_19,
            member_20, member_21, member_22, member_23, member_24, member_25, member_26, member_27, member_28, member_29,
@@ -640,7 +1907,13 @@ constexpr auto visit_aggregate(V visitor, T&& object) {
                    member_28, member_29, member_30, member_31, member_32, member_33, member_34, member_35, member_36,
                    member_37, member_38, member_39, member_40, member_41, member_42, member_43, member_44, member_45,
                    member_46, member_47, member_48, member_49, member_50, member_51, member_52, member_53);
-  } else if constexpr (member_count == 55) {
+  }
+};
+
+template <>
+struct Visitor<55> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
            member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18, member_19,
            member_20, member_21, member_22, member_23, member_24, member_25, member_26, member_27, member_28, member_29,
@@ -653,7 +1926,13 @@ constexpr auto visit_aggregate(V visitor, T&& object) {
                    member_28, member_29, member_30, member_31, member_32, member_33, member_34, member_35, member_36,
                    member_37, member_38, member_39, member_40, member_41, member_42, member_43, member_44, member_45,
                    member_46, member_47, member_48, member_49, member_50, member_51, member_52, member_53, member_54);
-  } else if constexpr (member_count == 56) {
+  }
+};
+
+template <>
+struct Visitor<56> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
            member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18, member_19,
            member_20, member_21, member_22, member_23, member_24, member_25, member_26, member_27, member_28, member_29,
@@ -667,7 +1946,13 @@ constexpr auto visit_aggregate(V visitor, T&& object) {
                    member_37, member_38, member_39, member_40, member_41, member_42, member_43, member_44, member_45,
                    member_46, member_47, member_48, member_49, member_50, member_51, member_52, member_53, member_54,
                    member_55);
-  } else if constexpr (member_count == 57) {
+  }
+};
+
+template <>
+struct Visitor<57> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
            member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18, member_19,
            member_20, member_21, member_22, member_23, member_24, member_25, member_26, member_27, member_28, member_29,
@@ -681,7 +1966,13 @@ constexpr auto visit_aggregate(V visitor, T&& object) {
                    member_37, member_38, member_39, member_40, member_41, member_42, member_43, member_44, member_45,
                    member_46, member_47, member_48, member_49, member_50, member_51, member_52, member_53, member_54,
                    member_55, member_56);
-  } else if constexpr (member_count == 58) {
+  }
+};
+
+template <>
+struct Visitor<58> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
            member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18, member_19,
            member_20, member_21, member_22, member_23, member_24, member_25, member_26, member_27, member_28, member_29,
@@ -695,7 +1986,13 @@ constexpr auto visit_aggregate(V visitor, T&& object) {
                    member_37, member_38, member_39, member_40, member_41, member_42, member_43, member_44, member_45,
                    member_46, member_47, member_48, member_49, member_50, member_51, member_52, member_53, member_54,
                    member_55, member_56, member_57);
-  } else if constexpr (member_count == 59) {
+  }
+};
+
+template <>
+struct Visitor<59> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
            member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18, member_19,
            member_20, member_21, member_22, member_23, member_24, member_25, member_26, member_27, member_28, member_29,
@@ -709,7 +2006,13 @@ constexpr auto visit_aggregate(V visitor, T&& object) {
                    member_37, member_38, member_39, member_40, member_41, member_42, member_43, member_44, member_45,
                    member_46, member_47, member_48, member_49, member_50, member_51, member_52, member_53, member_54,
                    member_55, member_56, member_57, member_58);
-  } else if constexpr (member_count == 60) {
+  }
+};
+
+template <>
+struct Visitor<60> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
            member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18, member_19,
            member_20, member_21, member_22, member_23, member_24, member_25, member_26, member_27, member_28, member_29,
@@ -724,7 +2027,13 @@ constexpr auto visit_aggregate(V visitor, T&& object) {
                    member_37, member_38, member_39, member_40, member_41, member_42, member_43, member_44, member_45,
                    member_46, member_47, member_48, member_49, member_50, member_51, member_52, member_53, member_54,
                    member_55, member_56, member_57, member_58, member_59);
-  } else if constexpr (member_count == 61) {
+  }
+};
+
+template <>
+struct Visitor<61> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
            member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18, member_19,
            member_20, member_21, member_22, member_23, member_24, member_25, member_26, member_27, member_28, member_29,
@@ -739,7 +2048,13 @@ constexpr auto visit_aggregate(V visitor, T&& object) {
                    member_37, member_38, member_39, member_40, member_41, member_42, member_43, member_44, member_45,
                    member_46, member_47, member_48, member_49, member_50, member_51, member_52, member_53, member_54,
                    member_55, member_56, member_57, member_58, member_59, member_60);
-  } else if constexpr (member_count == 62) {
+  }
+};
+
+template <>
+struct Visitor<62> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
            member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18, member_19,
            member_20, member_21, member_22, member_23, member_24, member_25, member_26, member_27, member_28, member_29,
@@ -754,7 +2069,13 @@ constexpr auto visit_aggregate(V visitor, T&& object) {
                    member_37, member_38, member_39, member_40, member_41, member_42, member_43, member_44, member_45,
                    member_46, member_47, member_48, member_49, member_50, member_51, member_52, member_53, member_54,
                    member_55, member_56, member_57, member_58, member_59, member_60, member_61);
-  } else if constexpr (member_count == 63) {
+  }
+};
+
+template <>
+struct Visitor<63> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
            member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18, member_19,
            member_20, member_21, member_22, member_23, member_24, member_25, member_26, member_27, member_28, member_29,
@@ -769,7 +2090,13 @@ constexpr auto visit_aggregate(V visitor, T&& object) {
                    member_37, member_38, member_39, member_40, member_41, member_42, member_43, member_44, member_45,
                    member_46, member_47, member_48, member_49, member_50, member_51, member_52, member_53, member_54,
                    member_55, member_56, member_57, member_58, member_59, member_60, member_61, member_62);
-  } else if constexpr (member_count == 64) {
+  }
+};
+
+template <>
+struct Visitor<64> {
+  template <typename V, typename T>
+  static constexpr auto visit(V& visitor, T& object) {
     auto& [member_0, member_1, member_2, member_3, member_4, member_5, member_6, member_7, member_8, member_9,
            member_10, member_11, member_12, member_13, member_14, member_15, member_16, member_17, member_18, member_19,
            member_20, member_21, member_22, member_23, member_24, member_25, member_26, member_27, member_28, member_29,
@@ -785,7 +2112,7 @@ constexpr auto visit_aggregate(V visitor, T&& object) {
                    member_46, member_47, member_48, member_49, member_50, member_51, member_52, member_53, member_54,
                    member_55, member_56, member_57, member_58, member_59, member_60, member_61, member_62, member_63);
   }
-}
+};
 }  // namespace visit_impl
 #  endif
 
@@ -796,7 +2123,7 @@ constexpr auto visit_aggregate(V visitor, T&& object) {
   auto& [... members] = object;
   return visitor(members...);
 #  else
-  return visit_impl::visit_aggregate(visitor, std::forward<T>(object));
+  return visit_impl::Visitor<arity<std::remove_cvref_t<T> > >::visit(visitor, object);
 #  endif
 }
 
@@ -837,12 +2164,30 @@ struct Wrap {
 template <typename T>
 extern const Wrap<T> fake_obj;
 
+template <std::size_t Idx, typename T>
+struct AddressSlot {
+  T* address;
+};
+
+template <typename Indices, typename... Ts>
+struct Addresses;
+
+// flat instead of std::tuple's recursive layout, picking one address is a single base class deduction
+template <std::size_t... Idx, typename... Ts>
+struct Addresses<std::index_sequence<Idx...>, Ts...> : AddressSlot<Idx, Ts>... {};
+
+template <std::size_t Idx, typename T>
+constexpr T* address_at(AddressSlot<Idx, T> const& slot) {
+  return slot.address;
+}
+
 template <typename T>
   requires(std::is_aggregate_v<std::remove_cvref_t<T> > && !std::is_array_v<std::remove_cvref_t<T> >)
 constexpr auto to_addr_tuple(T&& object) {
   return visit_aggregate(
       []<typename... Ts>(Ts&&... members) {
-        return std::tuple<std::remove_reference_t<Ts>*...>{std::addressof(members)...};
+        return Addresses<std::index_sequence_for<Ts...>, std::remove_reference_t<Ts>...>{
+            {std::addressof(members)}...};
       },
       std::forward<T>(object));
 }
@@ -854,7 +2199,7 @@ constexpr auto to_addr_tuple(T&& object) {
 
 template <typename T, std::size_t Idx>
   requires(std::is_aggregate_v<T> && !std::is_array_v<T>)
-inline constexpr auto member_name = name_from_subobject<T, get<Idx>(to_addr_tuple(fake_obj<T>.value))>();
+inline constexpr auto member_name = name_from_subobject<T, address_at<Idx>(to_addr_tuple(fake_obj<T>.value))>();
 
 #  if defined(__clang__)
 #    pragma clang diagnostic pop
@@ -866,72 +2211,1963 @@ template <typename T>
 inline constexpr auto member_names = []<std::size_t... Idx>(std::index_sequence<Idx...>) {
   return std::array{std::string_view{name_impl::member_name<T, Idx>}...};
 }(std::make_index_sequence<arity<T> >{});
+
+template <typename T, typename V>
+  requires(std::is_aggregate_v<std::remove_cv_t<T> > && !std::is_array_v<std::remove_cv_t<T> >)
+constexpr void for_each_member(T& object, V&& visitor) {
+  visit_aggregate(
+      [&]<typename... Ts>(Ts&... members) {
+        [&]<std::size_t... Idx>(std::index_sequence<Idx...>) {
+          (visitor.template operator()<Idx>(members), ...);
+        }(std::index_sequence_for<Ts...>{});
+      },
+      object);
+}
+
+template <std::size_t Idx, typename T>
+  requires(std::is_aggregate_v<std::remove_cv_t<T> > && !std::is_array_v<std::remove_cv_t<T> >)
+constexpr auto& get_member(T& object) {
+  return *name_impl::address_at<Idx>(name_impl::to_addr_tuple(object));
+}
 }  // namespace reflection
+#endif
+
+#if ERL_HAS_REFLECTION
+namespace reflection {
+template <typename T>
+inline constexpr std::size_t arity = nonstatic_data_members_of(^^T).size();
 
+template <typename T>
+inline constexpr auto member_names = [:meta::expand(nonstatic_data_members_of(^^T)):] >> []<auto... member> {
+  return std::array<std::string_view, sizeof...(member)>{std::string_view{define_static_string(identifier_of(member))}...};
+};
+
+template <typename T, typename V>
+constexpr void for_each_member(T& object, V&& visitor) {
+  [:meta::expand(std::views::iota(std::size_t{0}, arity<std::remove_cv_t<T> >)):] >> [&]<auto... Idx> {
+    (visitor.template operator()<Idx>(object.[:nonstatic_data_members_of(^^std::remove_cv_t<T>)[Idx]:]), ...);
+  };
+}
+
+template <std::size_t Idx, typename T>
+constexpr auto& get_member(T& object) {
+  return object.[:nonstatic_data_members_of(^^std::remove_cv_t<T>)[Idx]:];
+}
+}  // namespace reflection
 #endif
 
+namespace reflection {
+/// ELF hashes of every member name of `T`, computed at compile time so resolvers skip rehashing at load.
+template <typename T>
+inline constexpr auto member_hashes = []<std::size_t... Idx>(std::index_sequence<Idx...>) {
+  return std::array<platform::elf::SymbolHash, sizeof...(Idx)>{platform::elf::SymbolHash(member_names<T>[Idx])...};
+}(std::make_index_sequence<arity<T> >{});
+
+/// Member names as null-terminated strings with static storage, ready to be passed to the OS loader.
+template <typename T>
+inline constexpr auto member_cnames = []<std::size_t... Idx>(std::index_sequence<Idx...>) {
+  static_assert(((member_names<T>[Idx].data()[member_names<T>[Idx].size()] == '\0') && ...),
+                "member names must be null-terminated");
+  return std::array<char const*, sizeof...(Idx)>{member_names<T>[Idx].data()...};
+}(std::make_index_sequence<arity<T> >{});
+}  // namespace reflection
+
+/// Marks a Wrapper member as optional. A missing symbol leaves it null instead of failing the load.
+/// Calls and dereferences forward to the wrapped pointer, check for presence with `if (lib->member)`.
+template <typename T>
+  requires(std::is_pointer_v<T>)
+struct Optional {
+  T value = nullptr;
+
+  [[nodiscard]] constexpr explicit operator bool() const noexcept { return value != nullptr; }
+  [[nodiscard]] constexpr T get() const noexcept { return value; }
+
+  template <typename... Args>
+    requires(std::is_invocable_v<T, Args...>)
+  decltype(auto) operator()(Args&&... args) const {
+    return value(std::forward<Args>(args)...);
+  }
+
+  decltype(auto) operator*() const noexcept
+    requires(!std::is_function_v<std::remove_pointer_t<T> >)
+  {
+    return *value;
+  }
+
+  T operator->() const noexcept
+    requires(!std::is_function_v<std::remove_pointer_t<T> >)
+  {
+    return value;
+  }
+
+  friend constexpr bool operator==(Optional const&, Optional const&) = default;
+  friend constexpr bool operator==(Optional const& self, std::nullptr_t) noexcept { return self.value == nullptr; }
+};
+
+namespace _impl {
+template <typename T>
+struct optional_symbol {
+  static constexpr bool value = false;
+  using type                  = T;
+};
+
+template <typename T>
+struct optional_symbol<Optional<T> > {
+  static constexpr bool value = true;
+  using type                  = T;
+};
+
+// aggregate members other than `Optional` group further symbols instead of naming one themselves
+template <typename T>
+inline constexpr bool symbol_group =
+    std::is_class_v<T> && std::is_aggregate_v<T> && !std::is_array_v<T> && !optional_symbol<T>::value;
+}  // namespace _impl
+
+/// Wrappers may nest groups of symbols, e.g. `struct Api { CoreFns core; ExtFns ext; };`.
+/// The `symbol_*` views flatten such a Wrapper depth-first into one table of symbols, each named after its member.
+namespace reflection {
+namespace symbol_impl {
+template <typename T, std::size_t Idx>
+using member_t = std::remove_cvref_t<decltype(get_member<Idx>(std::declval<T&>()))>;
+
+template <typename T>
+struct Layout;
+
+template <typename M>
+constexpr std::size_t width() {
+  if constexpr (_impl::symbol_group<M>) {
+    return Layout<M>::offsets.back();
+  } else {
+    return 1;
+  }
+}
+
+template <typename T>
+struct Layout {
+  // flat index of the first symbol of every member, the last entry is the total
+  static constexpr auto offsets = []<std::size_t... Idx>(std::index_sequence<Idx...>) {
+    std::array<std::size_t, sizeof...(Idx) + 1> result{};
+    ((result[Idx + 1] = result[Idx] + width<member_t<T, Idx> >()), ...);
+    return result;
+  }(std::make_index_sequence<arity<T> >{});
+
+  static constexpr std::size_t member_of(std::size_t flat) {
+    std::size_t member = 0;
+    while (offsets[member + 1] <= flat) {
+      ++member;
+    }
+    return member;
+  }
+};
+}  // namespace symbol_impl
+
+template <typename T>
+inline constexpr std::size_t symbol_count = symbol_impl::Layout<T>::offsets.back();
+
+template <typename T>
+inline constexpr auto symbol_names = []<std::size_t... Idx>(std::index_sequence<Idx...>) {
+  constexpr auto const& offsets = symbol_impl::Layout<T>::offsets;
+  std::array<std::string_view, symbol_count<T> > names{};
+  (
+      [&] {
+        using M = symbol_impl::member_t<T, Idx>;
+        if constexpr (_impl::symbol_group<M>) {
+          for (std::size_t idx = 0; idx < symbol_count<M>; ++idx) {
+            names[offsets[Idx] + idx] = symbol_names<M>[idx];
+          }
+        } else {
+          names[offsets[Idx]] = member_names<T>[Idx];
+        }
+      }(),
+      ...);
+  return names;
+}(std::make_index_sequence<arity<T> >{});
+
+template <typename T>
+inline constexpr auto symbol_cnames = []<std::size_t... Idx>(std::index_sequence<Idx...>) {
+  constexpr auto const& offsets = symbol_impl::Layout<T>::offsets;
+  std::array<char const*, symbol_count<T> > names{};
+  (
+      [&] {
+        using M = symbol_impl::member_t<T, Idx>;
+        if constexpr (_impl::symbol_group<M>) {
+          for (std::size_t idx = 0; idx < symbol_count<M>; ++idx) {
+            names[offsets[Idx] + idx] = symbol_cnames<M>[idx];
+          }
+        } else {
+          names[offsets[Idx]] = member_cnames<T>[Idx];
+        }
+      }(),
+      ...);
+  return names;
+}(std::make_index_sequence<arity<T> >{});
+
+template <typename T>
+inline constexpr auto symbol_hashes = []<std::size_t... Idx>(std::index_sequence<Idx...>) {
+  return std::array<platform::elf::SymbolHash, sizeof...(Idx)>{platform::elf::SymbolHash(symbol_names<T>[Idx])...};
+}(std::make_index_sequence<symbol_count<T> >{});
+
+namespace symbol_impl {
+template <typename T>
+struct Bytes {
+  // byte offset of every member laid out in order, each at its alignment, the last entry is where the last one ends
+  static constexpr auto offsets = []<std::size_t... Idx>(std::index_sequence<Idx...>) {
+    std::array<std::size_t, sizeof...(Idx) + 1> result{};
+    ((result[Idx]     = (result[Idx] + alignof(member_t<T, Idx>) - 1) / alignof(member_t<T, Idx>) *
+                    alignof(member_t<T, Idx>),
+      result[Idx + 1] = result[Idx] + sizeof(member_t<T, Idx>)),
+     ...);
+    return result;
+  }(std::make_index_sequence<arity<T> >{});
+
+  // false if the compiler placed members differently, ie. because of `[[no_unique_address]]`
+  static constexpr bool exact = []<std::size_t... Idx>(std::index_sequence<Idx...>) {
+    auto padded = (offsets.back() + alignof(T) - 1) / alignof(T) * alignof(T);
+    return padded == sizeof(T) && ([] {
+             if constexpr (_impl::symbol_group<member_t<T, Idx> >) {
+               return Bytes<member_t<T, Idx> >::exact;
+             } else {
+               return true;
+             }
+           }() && ...);
+  }(std::make_index_sequence<arity<T> >{});
+};
+}  // namespace symbol_impl
+
+/// Byte offset and size of every symbol within `T`, by flat index. Only meaningful if `symbol_layout_exact<T>`.
+template <typename T>
+inline constexpr auto symbol_extents = []<std::size_t... Idx>(std::index_sequence<Idx...>) {
+  constexpr auto const& offsets = symbol_impl::Layout<T>::offsets;
+  constexpr auto const& bytes   = symbol_impl::Bytes<T>::offsets;
+  std::array<std::pair<std::size_t, std::size_t>, symbol_count<T> > extents{};
+  (
+      [&] {
+        using M = symbol_impl::member_t<T, Idx>;
+        if constexpr (_impl::symbol_group<M>) {
+          for (std::size_t idx = 0; idx < symbol_count<M>; ++idx) {
+            auto [offset, size]         = symbol_extents<M>[idx];
+            extents[offsets[Idx] + idx] = {bytes[Idx] + offset, size};
+          }
+        } else {
+          extents[offsets[Idx]] = {bytes[Idx], sizeof(M)};
+        }
+      }(),
+      ...);
+  return extents;
+}(std::make_index_sequence<arity<T> >{});
+
+template <typename T>
+inline constexpr bool symbol_layout_exact = symbol_impl::Bytes<T>::exact;
+
+/// Calls `visitor.template operator()<Idx>(member)` for every symbol, `Idx` being its flat index.
+template <std::size_t Offset = 0, typename T, typename V>
+  requires(std::is_aggregate_v<std::remove_cv_t<T> > && !std::is_array_v<std::remove_cv_t<T> >)
+constexpr void for_each_symbol(T& object, V&& visitor) {
+  for_each_member(object, [&]<std::size_t Idx>(auto& member) {
+    constexpr auto flat = Offset + symbol_impl::Layout<std::remove_cv_t<T> >::offsets[Idx];
+    if constexpr (_impl::symbol_group<std::remove_cvref_t<decltype(member)> >) {
+      for_each_symbol<flat>(member, visitor);
+    } else {
+      visitor.template operator()<flat>(member);
+    }
+  });
+}
+
+template <std::size_t Idx, typename T>
+  requires(std::is_aggregate_v<std::remove_cv_t<T> > && !std::is_array_v<std::remove_cv_t<T> >)
+constexpr auto& symbol_at(T& object) {
+  using layout          = symbol_impl::Layout<std::remove_cv_t<T> >;
+  constexpr auto member = layout::member_of(Idx);
+  auto& value           = get_member<member>(object);
+  if constexpr (_impl::symbol_group<std::remove_cvref_t<decltype(value)> >) {
+    return symbol_at<Idx - layout::offsets[member]>(value);
+  } else {
+    return value;
+  }
+}
+}  // namespace reflection
+
+/// Timings collected while constructing a `Library`.
+/// Only filled in when requested or when a `LoadObserver` is installed, otherwise loading does not read the clock.
+struct LoadStats {
+  using clock = std::chrono::steady_clock;
+
+  struct Symbol {
+    std::string_view name;
+    clock::time_point start;
+    clock::duration duration{};
+  };
+
+  struct Failure {
+    std::size_t index;
+    std::string_view name;
+  };
+
+  std::string path;
+  clock::time_point start;
+  clock::duration open_time{};
+  // spent in the `huge_text` policy, which runs first
+  clock::duration huge_text_time{};
+  // spent in the `prefault` policies
+  clock::duration prefault_time{};
+  clock::duration resolve_time{};
+  std::size_t symbol_count = 0;
+
+  // filled in by the `prefault` policies
+  std::size_t prefaulted_bytes = 0;
+  std::size_t locked_bytes     = 0;
+
+  // filled in by the `huge_text` policy
+  std::size_t huge_text_bytes = 0;
+
+  // resolved symbols in member order, empty if the library was shared with another instance or came from the cache
+  std::vector<Symbol> symbols;
+
+  // set if the symbol table was rebased from the on-disk cache of the `cached` policy
+  bool cached = false;
+
+  // set if resolving a symbol failed, `error` is set for any failure
+  std::optional<Failure> failure;
+  std::string error;
+
+  [[nodiscard]] clock::duration total() const noexcept {
+    return open_time + huge_text_time + prefault_time + resolve_time;
+  }
+};
+
+/// Process-wide hook notified after every `Library` construction, successful or not.
+class LoadObserver {
+public:
+  LoadObserver()                               = default;
+  LoadObserver(LoadObserver const&)            = delete;
+  LoadObserver& operator=(LoadObserver const&) = delete;
+  virtual ~LoadObserver()                      = default;
+
+  virtual void on_load(LoadStats const& stats) = 0;
+};
+
+namespace _impl {
+inline std::atomic<LoadObserver*> load_observer{nullptr};
+// loads that picked up an observer and may still call it, counted per generation so that `set_load_observer`
+// only waits for loads that started before it swapped the observer
+inline std::atomic<std::size_t> observer_users[2]{};
+inline std::atomic<unsigned> observer_generation{0};
+inline std::mutex observer_mutex;
+
+// the observer a load reports to, kept valid until the lease ends
+class ObserverLease {
+  LoadObserver* observer = nullptr;
+  unsigned generation    = 0;
+
+  static void release(unsigned generation) noexcept {
+    if (observer_users[generation].fetch_sub(1) == 1) {
+      observer_users[generation].notify_all();
+    }
+  }
+
+public:
+  ObserverLease() noexcept {
+    // loads without an observer take no lease at all
+    if (load_observer.load() == nullptr) {
+      return;
+    }
+    // counted before reading the pointer, so set_load_observer either waits for this load or hides the old observer
+    while (true) {
+      generation = observer_generation.load();
+      observer_users[generation].fetch_add(1);
+      if (observer_generation.load() == generation) {
+        break;
+      }
+      // swapped meanwhile, the counter we bumped may already have been drained
+      release(generation);
+    }
+    observer = load_observer.load();
+    if (observer == nullptr) {
+      release(generation);
+    }
+  }
+  ObserverLease(ObserverLease const&)            = delete;
+  ObserverLease& operator=(ObserverLease const&) = delete;
+
+  ~ObserverLease() {
+    if (observer != nullptr) {
+      release(generation);
+    }
+  }
+
+  [[nodiscard]] LoadObserver* get() const noexcept { return observer; }
+};
+}  // namespace _impl
+
+/// Installs `observer` (or removes the current one when passed `nullptr`) and returns the previous one.
+/// Returns once no load on another thread can still call the previous observer, so it may be destroyed right
+/// away. Loads starting afterwards are not waited for. Must not be called from within `on_load`, which would wait
+/// for itself.
+inline LoadObserver* set_load_observer(LoadObserver* observer) noexcept {
+  auto lock      = std::lock_guard(_impl::observer_mutex);
+  auto* previous = _impl::load_observer.exchange(observer);
+  auto draining  = _impl::observer_generation.load();
+  _impl::observer_generation.store(draining ^ 1U);
+  auto& users = _impl::observer_users[draining];
+  for (auto count = users.load(); count != 0; count = users.load()) {
+    users.wait(count);
+  }
+  return previous;
+}
+
+/// Tag for constructing a `Library` from a handle that was already opened by `platform::load_library`.
+struct adopt_handle_t {
+  explicit adopt_handle_t() = default;
+};
+inline constexpr adopt_handle_t adopt_handle{};
+
+/// Tag for constructing a `Library` from the library image readable through a file descriptor.
+struct from_fd_t {
+  explicit from_fd_t() = default;
+};
+inline constexpr from_fd_t from_fd{};
+
+/// Share one handle and one resolved symbol table between all live instances that load the same file.
+/// Instances are matched by device and inode rather than canonical path, so hard links and bind mounts of one file
+/// share too, or by name if the path is left to the loader's search. Every Wrapper type and flag set keeps its own
+/// table; the loader itself already returns one reference counted handle per file to all of them.
+/// Looking up an already loaded file takes no lock, only opening and closing do.
+struct shared {};
+
+namespace registry_impl {
 template <typename Wrapper>
-  requires(std::is_aggregate_v<Wrapper>)
-struct Library {
-private:
-  platform::handle_type handle;
-  Wrapper symbols;
+struct Entry {
+  std::uint64_t device = 0;
+  std::uint64_t inode  = 0;
+  std::string name;
+  Entry* next = nullptr;
 
-  template <typename T>
-  T load_symbol(std::string_view name) {
-#ifdef __GNUC__
-#  pragma GCC diagnostic push
-#  pragma GCC diagnostic ignored "-Wcast-function-type"
-#endif
+  // 0 means closed, revived under the registry's mutex only
+  std::atomic<std::size_t> references{0};
+  platform::handle_type handle = nullptr;
+  Wrapper symbols{};
+};
 
-    return reinterpret_cast<T>(platform::get_symbol(handle, name));
+// entries are never freed so readers can walk the list without taking the lock
+// instances loading with different flags must not share a handle, so every flag set gets its own registry
+template <typename Wrapper, LoadFlag Flags = LoadFlag::none>
+class Registry {
+  static inline std::atomic<Entry<Wrapper>*> head{nullptr};
+  static inline std::mutex writer;
 
-#ifdef __GNUC__
-#  pragma GCC diagnostic pop
+  struct Key {
+    std::uint64_t device = 0;
+    std::uint64_t inode  = 0;
+    std::string_view name;
+
+    explicit Key(char const* path) {
+#if !(defined(_WIN32) || defined(_WIN64))
+      struct stat info {};
+      // bare names are searched for by the loader, only explicit paths identify a file
+      if (std::string_view{path}.find('/') != std::string_view::npos && ::stat(path, &info) == 0) {
+        device = static_cast<std::uint64_t>(info.st_dev);
+        inode  = static_cast<std::uint64_t>(info.st_ino);
+        return;
+      }
 #endif
+      name = path;
+    }
+
+    [[nodiscard]] bool matches(Entry<Wrapper> const& entry) const noexcept {
+      return entry.device == device && entry.inode == inode && entry.name == name;
+    }
+  };
+
+  static Entry<Wrapper>* find(Key const& key) noexcept {
+    for (auto* entry = head.load(std::memory_order_acquire); entry != nullptr; entry = entry->next) {
+      if (key.matches(*entry)) {
+        return entry;
+      }
+    }
+    return nullptr;
   }
 
-  Wrapper load_symbols() {
-#if ERL_HAS_REFLECTION
-    return [:meta::expand(nonstatic_data_members_of(^^Wrapper)):] >> [&]<auto... member> {
-      return Wrapper{load_symbol<[:type_of(member):]>(identifier_of(member))...};
-    };
-#else
-    Wrapper ret{};
-    reflection::visit_aggregate<Wrapper&>(
-        [&]<typename... Ts>(Ts&... member) {
-          std::size_t idx = 0;
-          ((member = load_symbol<Ts>(reflection::member_names<Wrapper>[idx++].data())) && ...);
-        },
-        ret);
-    return ret;
-#endif
+  static bool try_reference(Entry<Wrapper>& entry) noexcept {
+    auto count = entry.references.load(std::memory_order_relaxed);
+    while (count != 0) {
+      if (entry.references.compare_exchange_weak(count, count + 1, std::memory_order_acquire)) {
+        return true;
+      }
+    }
+    return false;
   }
 
 public:
-  explicit Library(std::string_view path) : handle{platform::load_library(path)}, symbols(load_symbols()) {}
-  ~Library() { platform::unload_library(handle); }
+  /// Returns a referenced entry for `path`. `open` is called with the registry locked to fill in a closed entry.
+  template <typename F>
+  static Entry<Wrapper>& acquire(char const* path, F&& open) {
+    auto key = Key(path);
+    if (auto* entry = find(key); entry != nullptr && try_reference(*entry)) {
+      return *entry;
+    }
 
-  Library(Library const&)            = delete;
-  Library& operator=(Library const&) = delete;
+    auto lock   = std::lock_guard(writer);
+    auto* entry = find(key);
+    if (entry != nullptr && try_reference(*entry)) {
+      return *entry;
+    }
 
-  Library(Library&& other) noexcept : handle(other.handle), symbols(other.symbols) {
-    other.handle  = nullptr;
-    other.symbols = {};
-  }
+    auto created = std::unique_ptr<Entry<Wrapper> >{};
+    if (entry == nullptr) {
+      created         = std::make_unique<Entry<Wrapper> >();
+      created->device = key.device;
+      created->inode  = key.inode;
+      created->name   = key.name;
+      entry           = created.get();
+    }
 
-  Library& operator=(Library&& other) noexcept {
-    if (this != &other) {
-      std::swap(symbols, other.symbols);
-      std::swap(handle, other.handle);
+    // a closed entry might still hold its handle if the last release has not taken the lock yet
+    if (entry->handle == nullptr) {
+      std::forward<F>(open)(*entry);
     }
-    return *this;
+    entry->references.store(1, std::memory_order_release);
+
+    if (created) {
+      created->next = head.load(std::memory_order_relaxed);
+      head.store(created.release(), std::memory_order_release);
+    }
+    return *entry;
   }
 
-  Wrapper const& operator*() const { return symbols; }
-  Wrapper const* operator->() const { return &symbols; }
+  static void release(Entry<Wrapper>& entry) noexcept {
+    if (entry.references.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+      return;
+    }
+
+    auto lock = std::lock_guard(writer);
+    if (entry.references.load(std::memory_order_acquire) == 0 && entry.handle != nullptr) {
+      platform::unload_library(entry.handle);
+      entry.handle  = nullptr;
+      entry.symbols = {};
+    }
+  }
+};
+}  // namespace registry_impl
+
+/// Select the flags a `Library` type passes to the loader, ie. `load_flags<LoadFlag::no_delete>` for services that
+/// must never pay for unmapping or `load_flags<LoadFlag::lazy_binding>` for tools that want to start fast.
+/// With `LoadFlag::no_load` construction only binds to a library that is already loaded and throws otherwise.
+template <LoadFlag Flags>
+struct load_flags {
+  static constexpr LoadFlag value = Flags;
+};
+
+/// Fault in every loadable segment right after opening, so the first calls into the library do not take page faults.
+/// With `Lock` the segments are also `mlock`ed, as far as RLIMIT_MEMLOCK permits. `LoadStats` reports the bytes
+/// covered. Only has an effect on ELF targets.
+template <bool Lock = false>
+struct basic_prefault {
+  static constexpr bool lock = Lock;
+};
+using prefault = basic_prefault<>;
+using pinned   = basic_prefault<true>;
+
+/// Move the library's executable code onto transparent huge pages after loading, see
+/// `platform::remap_text_to_huge_pages`. Only code segments spanning at least one aligned 2 MiB block benefit.
+/// Falls back to the regular mapping whenever huge pages are unavailable. Only has an effect on ELF targets.
+struct huge_text {};
+
+/// Keep the resolved table on pages of its own, read-only once loading finished.
+/// Threads calling through `operator->` then never share a cache line with unrelated mutable state, and stray writes
+/// to the table fault instead of corrupting it. Cannot be combined with `lazy`, whose stubs patch the table.
+struct sealed {};
+
+/// Placement hint for `sealed` tables, ie. `hot<"draw", "present">`. The table is offset within its page so that
+/// the first of these members starts a cache line. All of them must fit on that one line, up to eight adjacent
+/// function pointers, which is checked at compile time.
+template <util::static_string... Names>
+struct hot {};
+
+/// Instruction set levels `variants` picks between, from least to most capable.
+enum class CpuLevel : std::uint8_t { baseline, sse42, avx2, avx512 };
+
+/// Bind every member to the most capable variant of its symbol the CPU supports, ie. `dot_avx512`, `dot_avx2` or
+/// `dot_sse42` before falling back to plain `dot`. The level is decided once per load, calls stay a plain indirect
+/// call. Lazy members pick their variant on first call instead. See `set_cpu_level` to force a level.
+struct variants {};
+
+namespace variant_impl {
+inline constexpr std::size_t levels = 4;
+inline constexpr std::array<std::string_view, levels> suffixes = {"", "_sse42", "_avx2", "_avx512"};
+
+template <typename T, std::size_t Level>
+inline constexpr std::size_t storage_size = [] {
+  std::size_t size = 0;
+  for (auto name : reflection::symbol_names<T>) {
+    size += name.size() + suffixes[Level].size() + 1;
+  }
+  return size;
+}();
+
+// every suffixed symbol name of `T`, null-terminated and back to back
+template <typename T, std::size_t Level>
+inline constexpr auto storage = [] {
+  std::array<char, storage_size<T, Level> > chars{};
+  auto out = chars.begin();
+  for (auto name : reflection::symbol_names<T>) {
+    out    = std::ranges::copy(name, out).out;
+    out    = std::ranges::copy(suffixes[Level], out).out;
+    *out++ = '\0';
+  }
+  return chars;
+}();
+
+template <typename T, std::size_t Level>
+inline constexpr auto names = [] {
+  std::array<std::string_view, reflection::symbol_count<T> > result{};
+  std::size_t offset = 0;
+  for (std::size_t idx = 0; idx < result.size(); ++idx) {
+    auto size   = reflection::symbol_names<T>[idx].size() + suffixes[Level].size();
+    result[idx] = std::string_view(storage<T, Level>.data() + offset, size);
+    offset += size + 1;
+  }
+  return result;
+}();
+
+/// `cnames<T>[Idx][Level]` names the variant of symbol `Idx` for `Level`, level 0 being the plain name.
+template <typename T>
+inline constexpr auto cnames = []<std::size_t... Level>(std::index_sequence<Level...>) {
+  std::array<std::array<char const*, levels>, reflection::symbol_count<T> > result{};
+  for (std::size_t idx = 0; idx < result.size(); ++idx) {
+    result[idx] = {reflection::symbol_cnames<T>[idx], names<T, Level + 1>[idx].data()...};
+  }
+  return result;
+}(std::make_index_sequence<levels - 1>{});
+
+template <typename T>
+inline constexpr auto hashes = []<std::size_t... Level>(std::index_sequence<Level...>) {
+  std::array<std::array<platform::elf::SymbolHash, levels>, reflection::symbol_count<T> > result{};
+  for (std::size_t idx = 0; idx < result.size(); ++idx) {
+    result[idx] = {reflection::symbol_hashes<T>[idx], platform::elf::SymbolHash(names<T, Level + 1>[idx])...};
+  }
+  return result;
+}(std::make_index_sequence<levels - 1>{});
+
+inline CpuLevel detect() noexcept {
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) {
+    return CpuLevel::avx512;
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    return CpuLevel::avx2;
+  }
+  if (__builtin_cpu_supports("sse4.2")) {
+    return CpuLevel::sse42;
+  }
+#elif (defined(_WIN32) || defined(_WIN64)) && defined(PF_AVX512F_INSTRUCTIONS_AVAILABLE)
+  if (::IsProcessorFeaturePresent(PF_AVX512F_INSTRUCTIONS_AVAILABLE)) {
+    return CpuLevel::avx512;
+  }
+  if (::IsProcessorFeaturePresent(PF_AVX2_INSTRUCTIONS_AVAILABLE)) {
+    return CpuLevel::avx2;
+  }
+  if (::IsProcessorFeaturePresent(PF_SSE4_2_INSTRUCTIONS_AVAILABLE)) {
+    return CpuLevel::sse42;
+  }
+#endif
+  return CpuLevel::baseline;
+}
+
+inline std::optional<CpuLevel> parse(std::string_view name) noexcept {
+  constexpr std::array<std::string_view, levels> level_names = {"baseline", "sse42", "avx2", "avx512"};
+  for (std::size_t idx = 0; idx < levels; ++idx) {
+    if (name == level_names[idx]) {
+      return static_cast<CpuLevel>(idx);
+    }
+  }
+  return std::nullopt;
+}
+
+inline std::mutex level_mutex;
+// unset until forced or read from the environment on first use
+inline std::optional<std::optional<CpuLevel> > forced;
+}  // namespace variant_impl
+
+/// Most capable level the running CPU supports. Always `baseline` on other architectures.
+[[nodiscard]] inline CpuLevel detected_cpu_level() noexcept {
+  static CpuLevel const level = variant_impl::detect();
+  return level;
+}
+
+/// Level `variants` binds against: the one forced through `set_cpu_level` or the `ERL_CPU_LEVEL` environment
+/// variable (`baseline`, `sse42`, `avx2` or `avx512`), otherwise the detected one.
+[[nodiscard]] inline CpuLevel cpu_level() {
+  auto lock = std::lock_guard(variant_impl::level_mutex);
+  if (!variant_impl::forced) {
+    char const* env      = std::getenv("ERL_CPU_LEVEL");
+    variant_impl::forced = env == nullptr ? std::nullopt : variant_impl::parse(env);
+  }
+  return variant_impl::forced->value_or(detected_cpu_level());
+}
+
+/// Forces the level `variants` binds against, overriding `ERL_CPU_LEVEL`. `std::nullopt` drops the override,
+/// the environment variable is read again and detection applies if it is unset.
+/// Only affects libraries loaded afterwards. Levels above the detected one bind code the CPU may not be able to run.
+inline void set_cpu_level(std::optional<CpuLevel> level) {
+  auto lock = std::lock_guard(variant_impl::level_mutex);
+  if (level) {
+    variant_impl::forced.emplace(level);
+  } else {
+    variant_impl::forced.reset();
+  }
+}
+
+/// Index the library's functions by address after loading, see `Library::address_index`.
+/// Lets in-process profilers and crash handlers name return addresses without calling `dladdr`.
+/// Only available on ELF targets.
+struct reverse_lookup {};
+
+/// Load a private copy of the library per instance, each in its own link-map namespace.
+/// Global state of the library (and of its dependencies) is no longer shared between instances, so workers can call
+/// into their own copy without locking. Only available with glibc, which limits a process to 15 live copies.
+struct isolated {};
+
+/// Persist resolved symbol offsets on disk, keyed by the library's build-id and the Wrapper's member names and types.
+/// A warm start rebases the stored offsets onto the load address instead of looking up any symbol.
+/// Caching is skipped unless a directory is configured through `set_symbol_cache_directory` or the
+/// `ERL_SYMBOL_CACHE_DIR` environment variable, and on targets without ELF lookup.
+/// Combined with `lazy`, a cold start binds every member so the stored entry also serves eager instances.
+struct cached {};
+
+namespace cache_impl {
+inline std::mutex directory_mutex;
+// every directory ever configured, kept so loads can use the current one without locking or copying it
+inline std::vector<std::unique_ptr<std::string const> > directories;
+// unset until configured or read from the environment on first use
+inline std::atomic<std::string const*> directory{nullptr};
+
+inline void set_directory(std::string path) {
+  auto lock = std::lock_guard(directory_mutex);
+  directory.store(directories.emplace_back(std::make_unique<std::string const>(std::move(path))).get(),
+                  std::memory_order_release);
+}
+
+inline std::string const& get_directory() {
+  if (auto const* current = directory.load(std::memory_order_acquire)) {
+    return *current;
+  }
+  {
+    auto lock = std::lock_guard(directory_mutex);
+    if (directory.load(std::memory_order_relaxed) == nullptr) {
+      char const* env = std::getenv("ERL_SYMBOL_CACHE_DIR");
+      directory.store(directories.emplace_back(std::make_unique<std::string const>(env == nullptr ? "" : env)).get(),
+                      std::memory_order_release);
+    }
+  }
+  return *directory.load(std::memory_order_acquire);
+}
+
+#if ERL_HAS_ELF_LOOKUP
+inline constexpr std::uint64_t fnv_offset = 0xcbf2'9ce4'8422'2325ULL;
+inline constexpr std::uint64_t fnv_prime  = 0x0000'0100'0000'01b3ULL;
+
+constexpr std::uint64_t fnv1a(std::uint64_t hash, std::string_view data) noexcept {
+  for (char chr : data) {
+    hash = (hash ^ static_cast<unsigned char>(chr)) * fnv_prime;
+  }
+  return hash;
+}
+
+// spells out T, stable for one compiler, which is all the cache key needs. The fixed prefix also separates it from
+// the preceding member name in the signature
+template <typename T>
+constexpr std::string_view type_signature() noexcept {
+  return __PRETTY_FUNCTION__;
+}
+
+template <typename Wrapper>
+inline constexpr std::uint64_t signature = []<std::size_t... Idx>(std::index_sequence<Idx...>) {
+  auto hash = fnv_offset;
+  ((hash = fnv1a(fnv1a(hash, reflection::symbol_names<Wrapper>[Idx]),
+                 type_signature<decltype(reflection::symbol_at<Idx>(std::declval<Wrapper&>()))>())),
+   ...);
+  return hash;
+}(std::make_index_sequence<reflection::symbol_count<Wrapper> >{});
+
+inline constexpr std::uint64_t magic   = 0x3130'6d79'736c'7265ULL;  // "erlsym01"
+inline constexpr std::uint64_t missing = ~std::uint64_t{0};
+
+struct Object {
+  std::uintptr_t base  = 0;
+  std::uintptr_t begin = 0;
+  std::uintptr_t end   = 0;
+  std::uint32_t build_id_size = 0;
+  unsigned char build_id[64]{};
+
+  [[nodiscard]] bool contains(std::uintptr_t address) const noexcept { return address >= begin && address < end; }
+};
+
+struct Header {
+  std::uint64_t magic;
+  std::uint64_t signature;
+  std::uint64_t checksum;
+  std::uint32_t count;
+  std::uint32_t build_id_size;
+  unsigned char build_id[64];
+};
+
+inline void read_build_id(Object& object, ElfW(Phdr) const& note) noexcept {
+  auto align    = note.p_align < 4 ? std::uintptr_t{4} : static_cast<std::uintptr_t>(note.p_align);
+  auto padded   = [&](std::uintptr_t size) { return (size + align - 1) & ~(align - 1); };
+  auto position = object.base + note.p_vaddr;
+  auto end      = position + note.p_memsz;
+
+  while (position + sizeof(ElfW(Nhdr)) <= end) {
+    auto const* header = reinterpret_cast<ElfW(Nhdr) const*>(position);
+    auto const* name   = reinterpret_cast<char const*>(position + sizeof(ElfW(Nhdr)));
+    auto const* desc   = reinterpret_cast<unsigned char const*>(name + padded(header->n_namesz));
+    position = reinterpret_cast<std::uintptr_t>(desc) + padded(header->n_descsz);
+    if (position > end) {
+      return;
+    }
+
+    if (header->n_type == NT_GNU_BUILD_ID && header->n_namesz == 4 && std::memcmp(name, "GNU", 4) == 0 &&
+        header->n_descsz != 0 && header->n_descsz <= sizeof(object.build_id)) {
+      object.build_id_size = header->n_descsz;
+      std::memcpy(object.build_id, desc, header->n_descsz);
+      return;
+    }
+  }
+}
+
+/// Finds the load address, mapped range and build-id of an already loaded object.
+inline bool identify(platform::handle_type handle, Object& object) noexcept {
+  auto found = platform::elf::with_program_headers(handle, [&](dl_phdr_info const& info) {
+    object.base  = info.dlpi_addr;
+    object.begin = ~std::uintptr_t{0};
+    for (std::size_t idx = 0; idx < info.dlpi_phnum; ++idx) {
+      auto const& header = info.dlpi_phdr[idx];
+      if (header.p_type == PT_LOAD) {
+        object.begin = std::min<std::uintptr_t>(object.begin, info.dlpi_addr + header.p_vaddr);
+        object.end   = std::max<std::uintptr_t>(object.end, info.dlpi_addr + header.p_vaddr + header.p_memsz);
+      } else if (header.p_type == PT_NOTE && object.build_id_size == 0) {
+        read_build_id(object, header);
+      }
+    }
+  });
+  return found && object.build_id_size != 0 && object.begin < object.end;
+}
+
+inline std::uint64_t checksum(Object const& object, std::uint64_t const* offsets, std::size_t count) noexcept {
+  auto hash = fnv1a(fnv_offset, {reinterpret_cast<char const*>(object.build_id), object.build_id_size});
+  return fnv1a(hash, {reinterpret_cast<char const*>(offsets), count * sizeof(std::uint64_t)});
+}
+
+inline std::string file_path(std::string_view directory, Object const& object, std::uint64_t signature) {
+  constexpr char digits[] = "0123456789abcdef";
+  auto path = std::string{directory};
+  path += '/';
+  for (std::size_t idx = 0; idx < object.build_id_size; ++idx) {
+    path += digits[object.build_id[idx] >> 4U];
+    path += digits[object.build_id[idx] & 0xfU];
+  }
+  path += '-';
+  for (int shift = 60; shift >= 0; shift -= 4) {
+    path += digits[(signature >> static_cast<unsigned>(shift)) & 0xfU];
+  }
+  path += ".symbols";
+  return path;
+}
+
+/// Maps the cache file at `path` and returns its offsets. Files that are truncated, corrupt or belong to another
+/// build or Wrapper are rejected with `nullptr`. The mapping is never released, see `Memo`.
+inline std::uint64_t const* map(std::string const& path, Object const& object, std::uint64_t signature,
+                                std::size_t count) noexcept {
+  int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return nullptr;
+  }
+  auto size        = sizeof(Header) + count * sizeof(std::uint64_t);
+  struct stat info {};
+  void* mapping    = MAP_FAILED;
+  if (::fstat(fd, &info) == 0 && static_cast<std::size_t>(info.st_size) == size) {
+    mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  }
+  ::close(fd);
+  if (mapping == MAP_FAILED) {
+    return nullptr;
+  }
+
+  auto const* header  = static_cast<Header const*>(mapping);
+  auto const* offsets = reinterpret_cast<std::uint64_t const*>(static_cast<unsigned char const*>(mapping) + sizeof(Header));
+  if (header->magic != magic || header->signature != signature || header->count != count ||
+      header->build_id_size != object.build_id_size ||
+      std::memcmp(header->build_id, object.build_id, object.build_id_size) != 0 ||
+      header->checksum != checksum(object, offsets, count)) {
+    ::munmap(mapping, size);
+    return nullptr;
+  }
+  return offsets;
+}
+
+/// Offsets this process already read or wrote, so later loads of the same library need no file access at all.
+/// A build-id and signature always describe the same offsets, so entries stay valid and are never freed.
+/// Entries are also keyed by the configured directory, setting it again starts over.
+class Memo {
+  struct Entry {
+    std::string const* directory;
+    std::uint64_t signature;
+    std::uint32_t build_id_size;
+    unsigned char build_id[64];
+    std::uint64_t const* offsets;
+    Entry* next;
+  };
+
+  static inline std::atomic<Entry*> head{nullptr};
+  static inline std::mutex writer;
+
+public:
+  static std::uint64_t const* find(std::string const& directory, Object const& object,
+                                   std::uint64_t signature) noexcept {
+    for (auto* entry = head.load(std::memory_order_acquire); entry != nullptr; entry = entry->next) {
+      if (entry->directory == &directory && entry->signature == signature &&
+          entry->build_id_size == object.build_id_size &&
+          std::memcmp(entry->build_id, object.build_id, object.build_id_size) == 0) {
+        return entry->offsets;
+      }
+    }
+    return nullptr;
+  }
+
+  // newer entries shadow older ones
+  static void remember(std::string const& directory, Object const& object, std::uint64_t signature,
+                       std::uint64_t const* offsets) {
+    auto* entry = new Entry{&directory, signature, object.build_id_size, {}, offsets, nullptr};
+    std::memcpy(entry->build_id, object.build_id, object.build_id_size);
+    auto lock   = std::lock_guard(writer);
+    entry->next = head.load(std::memory_order_relaxed);
+    head.store(entry, std::memory_order_release);
+  }
+};
+
+/// Stored offsets for `object`, from memory if this process saw them before, otherwise from the cache file.
+inline std::uint64_t const* lookup(std::string const& directory, Object const& object, std::uint64_t signature,
+                                   std::size_t count) {
+  if (auto const* offsets = Memo::find(directory, object, signature)) {
+    return offsets;
+  }
+  auto const* offsets = map(file_path(directory, object, signature), object, signature, count);
+  if (offsets != nullptr) {
+    Memo::remember(directory, object, signature, offsets);
+  }
+  return offsets;
+}
+
+/// Publishes a cache file. Every writer fills its own temporary file and renames it into place, so concurrent
+/// writers and readers only ever see complete files.
+inline void write(std::string const& path, Object const& object, std::uint64_t signature,
+                  std::uint64_t const* offsets, std::size_t count) {
+  Header header{magic, signature, checksum(object, offsets, count), static_cast<std::uint32_t>(count),
+                object.build_id_size, {}};
+  std::memcpy(header.build_id, object.build_id, object.build_id_size);
+
+  auto buffer = std::vector<unsigned char>(sizeof(Header) + count * sizeof(std::uint64_t));
+  std::memcpy(buffer.data(), &header, sizeof(Header));
+  std::memcpy(buffer.data() + sizeof(Header), offsets, count * sizeof(std::uint64_t));
+
+  auto temporary = path + ".XXXXXX";
+  int fd         = ::mkstemp(temporary.data());
+  if (fd < 0) {
+    return;
+  }
+  ::fchmod(fd, 0644);
+
+  std::size_t written = 0;
+  while (written < buffer.size()) {
+    auto result = ::write(fd, buffer.data() + written, buffer.size() - written);
+    if (result <= 0) {
+      break;
+    }
+    written += static_cast<std::size_t>(result);
+  }
+
+  if (::close(fd) != 0 || written != buffer.size() || ::rename(temporary.c_str(), path.c_str()) != 0) {
+    ::unlink(temporary.c_str());
+  }
+}
+#endif
+}  // namespace cache_impl
+
+/// Sets the directory used by the `cached` policy, overriding `ERL_SYMBOL_CACHE_DIR`. An empty path disables caching.
+/// The directory must already exist.
+inline void set_symbol_cache_directory(std::string_view path) {
+  cache_impl::set_directory(std::string{path});
+}
+
+/// Resolve every symbol on first use instead of at construction.
+/// Function pointer members start out pointing at a stub which resolves the real symbol, patches the member and
+/// forwards the call. Data members, variadic and noexcept functions cannot be stubbed and are resolved eagerly.
+/// Stubs carry no state, so every live lazy `Library` of one type occupies one of `MaxInstances` slots. Instances
+/// created while all slots are taken resolve eagerly instead.
+/// Stubs find their instance through the slot, so they must not outlive or escape it: calling a stub copied out of a
+/// destroyed instance throws `LibraryError`, and once another instance took over the slot the stub resolves against
+/// and patches that one instead. First calls must not race with moving the instance either.
+template <std::size_t MaxInstances = 4>
+struct basic_lazy {
+  static constexpr std::size_t max_instances = MaxInstances;
+};
+using lazy = basic_lazy<>;
+
+/// Route every function pointer member through a probe that counts and times its calls, see `Library::call_stats`.
+/// Counters are kept per thread and per `Library` type, so probes never contend and need no atomic read-modify-write.
+/// They are not per instance: all libraries of one type report together, use distinct Wrapper types to tell them apart.
+/// Like lazy stubs, probes carry no state: every live instrumented `Library` of one type occupies one of
+/// `MaxInstances` slots, and probes must not outlive their instance. Data members, variadic and noexcept functions are
+/// not instrumented.
+/// Defining `ERL_INSTRUMENTATION` as false compiles the probes out, instrumented libraries then call straight through.
+/// The setting selects the inline namespace the policy lives in, so translation units built with different values
+/// name different `Library` types instead of silently violating the one definition rule.
+#if ERL_INSTRUMENTATION
+inline namespace instrumentation_on {
+#else
+inline namespace instrumentation_off {
+#endif
+template <std::size_t MaxInstances = 4>
+struct basic_instrumented {
+  static constexpr std::size_t max_instances = MaxInstances;
+  static constexpr bool probes               = ERL_INSTRUMENTATION;
+};
+using instrumented = basic_instrumented<>;
+}  // inline namespace instrumentation_on / instrumentation_off
+
+/// Calls into one member of an instrumented `Library`, merged over every thread.
+struct CallStats {
+  static constexpr std::size_t buckets = 32;
+
+  std::string_view name;
+  std::uint64_t calls = 0;
+  std::chrono::nanoseconds total{};
+  /// `histogram[i]` counts calls taking less than 2^i ns but at least half that, the last bucket every slower call.
+  std::array<std::uint64_t, buckets> histogram{};
+};
+
+namespace instrument_impl {
+struct Counter {
+  std::uint64_t calls;
+  std::uint64_t nanoseconds;
+  std::uint64_t histogram[CallStats::buckets];
+};
+
+// only the owning thread writes, relaxed accesses keep concurrent snapshots well defined without locked instructions
+inline void bump(std::uint64_t& value, std::uint64_t amount) noexcept {
+  auto counter = std::atomic_ref<std::uint64_t>(value);
+  counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+inline std::uint64_t peek(std::uint64_t const& value) noexcept {
+  return std::atomic_ref<std::uint64_t>(const_cast<std::uint64_t&>(value)).load(std::memory_order_relaxed);
+}
+
+template <typename Tag, std::size_t Count>
+struct Counters {
+  // counters of one thread are packed, only the block is padded to its own cache lines
+  struct alignas(64) Block {
+    Counter counters[Count]{};
+  };
+
+  // every thread registers its own block on its first call and folds it into `retired` when it exits
+  struct Local {
+    Block* block = nullptr;
+
+    Local() = default;
+    Local(Local const&)            = delete;
+    Local& operator=(Local const&) = delete;
+    ~Local() {
+      if (block == nullptr) {
+        return;
+      }
+      auto lock = std::lock_guard(mutex);
+      for (std::size_t idx = 0; idx < Count; ++idx) {
+        auto& into = retired.counters[idx];
+        auto& from = block->counters[idx];
+        into.calls += from.calls;
+        into.nanoseconds += from.nanoseconds;
+        for (std::size_t bucket = 0; bucket < CallStats::buckets; ++bucket) {
+          into.histogram[bucket] += from.histogram[bucket];
+        }
+      }
+      std::erase(live, block);
+      delete block;
+    }
+  };
+
+  static inline std::mutex mutex;
+  static inline std::vector<Block*> live;
+  static inline Block retired;
+  static inline thread_local Local local;
+
+  static void record(std::size_t idx, std::uint64_t nanoseconds) {
+    if (local.block == nullptr) [[unlikely]] {
+      auto created = std::make_unique<Block>();
+      auto lock    = std::lock_guard(mutex);
+      live.push_back(created.get());
+      local.block = created.release();
+    }
+
+    auto& counter = local.block->counters[idx];
+    bump(counter.calls, 1);
+    bump(counter.nanoseconds, nanoseconds);
+    bump(counter.histogram[std::min<std::size_t>(std::bit_width(nanoseconds), CallStats::buckets - 1)], 1);
+  }
+
+  static void merge(std::span<CallStats> result) {
+    auto collect = [&](Block const& block) {
+      for (std::size_t idx = 0; idx < Count; ++idx) {
+        auto const& counter = block.counters[idx];
+        result[idx].calls += peek(counter.calls);
+        result[idx].total += std::chrono::nanoseconds(peek(counter.nanoseconds));
+        for (std::size_t bucket = 0; bucket < CallStats::buckets; ++bucket) {
+          result[idx].histogram[bucket] += peek(counter.histogram[bucket]);
+        }
+      }
+    };
+
+    auto lock = std::lock_guard(mutex);
+    collect(retired);
+    for (auto const* block : live) {
+      collect(*block);
+    }
+  }
+};
+}  // namespace instrument_impl
+
+namespace policy_impl {
+template <typename T>
+inline constexpr std::size_t lazy_instances_of = 0;
+
+template <std::size_t N>
+inline constexpr std::size_t lazy_instances_of<basic_lazy<N> > = N;
+
+template <typename... Policies>
+inline constexpr std::size_t lazy_instances = (lazy_instances_of<Policies> + ... + 0);
+
+// matched by shape rather than by name, `basic_instrumented` differs between translation units
+template <typename T>
+concept instrumentation_policy = requires {
+  { T::max_instances } -> std::convertible_to<std::size_t>;
+  { T::probes } -> std::convertible_to<bool>;
+};
+
+template <typename T>
+inline constexpr std::size_t instrumented_instances_of = 0;
+
+template <instrumentation_policy T>
+inline constexpr std::size_t instrumented_instances_of<T> = T::max_instances;
+
+template <typename... Policies>
+inline constexpr std::size_t instrumented_instances = (instrumented_instances_of<Policies> + ... + 0);
+
+template <typename T>
+inline constexpr bool probes_of = false;
+
+template <instrumentation_policy T>
+inline constexpr bool probes_of<T> = T::probes;
+
+template <typename... Policies>
+inline constexpr bool has_probes = (probes_of<Policies> || ...);
+
+template <typename... Policies>
+inline constexpr bool is_shared = (std::is_same_v<Policies, shared> || ...);
+
+template <typename... Policies>
+inline constexpr bool is_cached = (std::is_same_v<Policies, cached> || ...);
+
+template <typename... Policies>
+inline constexpr bool is_isolated = (std::is_same_v<Policies, isolated> || ...);
+
+template <typename... Policies>
+inline constexpr bool is_huge_text = (std::is_same_v<Policies, huge_text> || ...);
+
+template <typename... Policies>
+inline constexpr bool is_sealed = (std::is_same_v<Policies, sealed> || ...);
+
+template <typename T>
+inline constexpr std::array<std::string_view, 0> hot_names_of{};
+
+template <util::static_string... Names>
+inline constexpr std::array<std::string_view, sizeof...(Names)> hot_names_of<hot<Names...> > = {
+    std::string_view{Names}...};
+
+template <typename... Policies>
+inline constexpr auto hot_names = []<std::size_t... Idx>(std::index_sequence<Idx...>) {
+  // where the names of every policy start, the last entry is the total
+  constexpr auto starts = [] {
+    std::array<std::size_t, sizeof...(Policies) + 1> result{};
+    ((result[Idx + 1] = result[Idx] + hot_names_of<Policies>.size()), ...);
+    return result;
+  }();
+  auto names = std::array<std::string_view, starts.back()>{};
+  (std::ranges::copy(hot_names_of<Policies>, names.begin() + starts[Idx]), ...);
+  return names;
+}(std::index_sequence_for<Policies...>{});
+
+template <typename... Policies>
+inline constexpr bool is_variants = (std::is_same_v<Policies, variants> || ...);
+
+template <typename... Policies>
+inline constexpr bool is_reverse_lookup = (std::is_same_v<Policies, reverse_lookup> || ...);
+
+template <typename T>
+inline constexpr unsigned prefault_of = 0;
+
+template <bool Lock>
+inline constexpr unsigned prefault_of<basic_prefault<Lock> > = Lock ? 3U : 1U;
+
+// bit 0 prefaults, bit 1 also locks
+template <typename... Policies>
+inline constexpr unsigned prefault_mode = (prefault_of<Policies> | ... | 0U);
+
+template <typename T>
+inline constexpr LoadFlag load_flags_of = LoadFlag::none;
+
+template <LoadFlag Flags>
+inline constexpr LoadFlag load_flags_of<load_flags<Flags> > = Flags;
+
+template <typename... Policies>
+inline constexpr LoadFlag flags = (load_flags_of<Policies> | ... | LoadFlag::none);
+
+// reports the duration of the enclosing call when leaving it, also when it throws
+template <auto Record>
+struct CallTimer {
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+  CallTimer() = default;
+  CallTimer(CallTimer const&)            = delete;
+  CallTimer& operator=(CallTimer const&) = delete;
+  ~CallTimer() { Record(std::chrono::steady_clock::now() - start); }
+};
+
+template <typename T>
+struct stub_traits {
+  static constexpr bool stubbable = false;
+};
+
+template <typename R, typename... Args>
+struct stub_traits<R (*)(Args...)> {
+  static constexpr bool stubbable = true;
+
+  template <auto Resolve>
+  static R stub(Args... args) {
+    return Resolve()(std::forward<Args>(args)...);
+  }
+
+  template <auto Target, auto Record>
+  static R probe(Args... args) {
+    auto timer = CallTimer<Record>{};
+    return Target()(std::forward<Args>(args)...);
+  }
+};
+}  // namespace policy_impl
+
+template <typename Wrapper, typename... Policies>
+  requires(std::is_aggregate_v<Wrapper>)
+struct Library {
+private:
+  static constexpr std::size_t lazy_slots = policy_impl::lazy_instances<Policies...>;
+  static constexpr bool is_lazy           = lazy_slots != 0;
+  static constexpr std::size_t instrumented_slots = policy_impl::instrumented_instances<Policies...>;
+  static constexpr bool is_instrumented           = policy_impl::has_probes<Policies...> && instrumented_slots != 0;
+  static constexpr std::size_t slot_count = is_lazy ? lazy_slots : (is_instrumented ? instrumented_slots : 0);
+  static constexpr std::size_t no_slot    = static_cast<std::size_t>(-1);
+  static constexpr bool is_shared         = policy_impl::is_shared<Policies...>;
+  static constexpr bool is_cached         = ERL_HAS_ELF_LOOKUP && policy_impl::is_cached<Policies...>;
+  static constexpr bool is_isolated       = policy_impl::is_isolated<Policies...>;
+  static_assert(!(is_lazy && is_shared), "lazy stubs patch their own table, which cannot be shared");
+  static_assert(!(is_instrumented && is_shared), "probes forward through their own table, which cannot be shared");
+  static_assert(!(is_instrumented && is_lazy), "lazy stubs would replace the probes on first call");
+  static_assert(!(is_isolated && is_shared), "isolated instances cannot share a handle");
+  static_assert(!is_isolated || ERL_HAS_DLMOPEN, "erl::isolated requires dlmopen");
+
+  static constexpr LoadFlag loader_flags = policy_impl::flags<Policies...>;
+  static constexpr unsigned prefault_mode = ERL_HAS_ELF_LOOKUP ? policy_impl::prefault_mode<Policies...> : 0U;
+  static constexpr bool is_huge_text      = ERL_HAS_ELF_LOOKUP && policy_impl::is_huge_text<Policies...>;
+  static_assert(!(is_isolated && has_flag(loader_flags, LoadFlag::global)), "isolated libraries cannot be global");
+  static constexpr bool is_reverse_lookup = policy_impl::is_reverse_lookup<Policies...>;
+  static_assert(!is_reverse_lookup || ERL_HAS_ELF_LOOKUP, "erl::reverse_lookup requires ELF lookup");
+
+  static constexpr bool is_sealed = policy_impl::is_sealed<Policies...>;
+  static constexpr auto hot_names = policy_impl::hot_names<Policies...>;
+  static constexpr bool is_variants = policy_impl::is_variants<Policies...>;
+
+  static_assert(!(is_sealed && is_lazy), "lazy stubs patch the table, which is read-only once sealed");
+  static_assert(hot_names.empty() || is_sealed, "erl::hot only applies to sealed tables");
+  static_assert(std::ranges::all_of(hot_names,
+                                    [](std::string_view name) {
+                                      return std::ranges::find(reflection::symbol_names<Wrapper>, name) !=
+                                             reflection::symbol_names<Wrapper>.end();
+                                    }),
+                "erl::hot names a member the Wrapper does not have");
+  static_assert(hot_names.empty() || reflection::symbol_layout_exact<Wrapper>,
+                "erl::hot cannot tell where this Wrapper's members are placed");
+
+  static constexpr std::size_t cache_line = 64;
+
+  // first and one past the last byte any hot member occupies within `Wrapper`
+  static constexpr auto hot_span = [] {
+    auto span = std::pair{sizeof(Wrapper), std::size_t{0}};
+    for (std::size_t idx = 0; idx < reflection::symbol_count<Wrapper>; ++idx) {
+      if (std::ranges::find(hot_names, reflection::symbol_names<Wrapper>[idx]) != hot_names.end()) {
+        auto [offset, size] = reflection::symbol_extents<Wrapper>[idx];
+        span                = {std::min(span.first, offset), std::max(span.second, offset + size)};
+      }
+    }
+    return span;
+  }();
+
+  // bytes the sealed table is placed into its first page, puts the first hot member at the start of a cache line
+  static constexpr std::size_t seal_offset = [] {
+    if constexpr (hot_names.empty()) {
+      return std::size_t{0};
+    } else {
+      auto offset = (cache_line - hot_span.first % cache_line) % cache_line;
+      return offset - offset % alignof(Wrapper);
+    }
+  }();
+  static_assert(hot_names.empty() || (seal_offset + hot_span.first) % cache_line + (hot_span.second - hot_span.first) <=
+                                         cache_line,
+                "erl::hot members do not fit on one cache line, declare them next to each other");
+
+  using registry      = registry_impl::Registry<Wrapper, loader_flags>;
+  using call_counters = instrument_impl::Counters<Library, std::max<std::size_t>(reflection::symbol_count<Wrapper>, 1)>;
+  struct unshared {};
+
+  platform::handle_type handle;
+  Wrapper symbols;
+  std::size_t slot = no_slot;
+  [[no_unique_address]] std::conditional_t<is_shared, registry_impl::Entry<Wrapper>*, unshared> entry{};
+  // the resolved symbols the probes forward to
+  [[no_unique_address]] std::conditional_t<is_instrumented, Wrapper, unshared> targets{};
+#if ERL_HAS_ELF_LOOKUP
+  [[no_unique_address]] std::conditional_t<is_reverse_lookup, platform::elf::AddressIndex, unshared> index{};
+#endif
+  // read-only copy of `symbols`, `seal_offset` bytes into pages of its own
+  [[no_unique_address]] std::conditional_t<is_sealed, Wrapper const*, unshared> sealed_table{};
+#if ERL_HAS_MEMFD
+  // backs libraries loaded from memory, see `platform::MemoryImage`
+  int image = -1;
+#endif
+
+  // one entry per lazy or instrumented slot, pointing at the instance currently owning it
+  static inline std::atomic<Library*> slot_owners[slot_count != 0 ? slot_count : 1]{};
+
+  template <typename T>
+  static T symbol_cast(platform::symbol_type symbol) {
+#ifdef __GNUC__
+#  pragma GCC diagnostic push
+#  pragma GCC diagnostic ignored "-Wcast-function-type"
+#endif
+
+    return reinterpret_cast<T>(symbol);
+
+#ifdef __GNUC__
+#  pragma GCC diagnostic pop
+#endif
+  }
+
+  template <typename T>
+  T load_symbol(char const* name) {
+    return symbol_cast<T>(platform::get_symbol(handle, name));
+  }
+
+  template <std::size_t Idx>
+  using member_type = std::remove_cvref_t<decltype(reflection::symbol_at<Idx>(std::declval<Wrapper&>()))>;
+
+  // stubs and probes copied out of a destroyed instance fail loudly instead of dereferencing nothing
+  template <std::size_t Slot, std::size_t Idx>
+  static Library* slot_owner() {
+    auto* owner = slot_owners[Slot].load(std::memory_order_acquire);
+    if (owner == nullptr) [[unlikely]] {
+      throw LibraryError(std::string{reflection::symbol_names<Wrapper>[Idx]} +
+                         " called through a stub whose Library was destroyed");
+    }
+    return owner;
+  }
+
+  template <std::size_t Slot, std::size_t Idx>
+  static member_type<Idx> resolve_lazy() {
+    using T    = member_type<Idx>;
+    auto* self = slot_owner<Slot, Idx>();
+    auto fnc   = T{};
+    if constexpr (is_variants) {
+      auto symbol = find_symbol<Idx>(platform::SymbolResolver(self->handle), cpu_level());
+      // no variant at all, let the loader report the plain name
+      fnc = symbol != nullptr ? symbol_cast<T>(symbol)
+                              : self->template load_symbol<T>(reflection::symbol_cnames<Wrapper>[Idx]);
+    } else {
+      fnc = self->template load_symbol<T>(reflection::symbol_cnames<Wrapper>[Idx]);
+    }
+    // concurrent first calls resolve the same address, so racing stores are benign
+    std::atomic_ref<T>(reflection::symbol_at<Idx>(self->symbols)).store(fnc, std::memory_order_release);
+    return fnc;
+  }
+
+  template <std::size_t Idx>
+  static member_type<Idx> lazy_stub(std::size_t slot) {
+    return []<std::size_t... Slot>(std::size_t idx, std::index_sequence<Slot...>) {
+      using traits                       = policy_impl::stub_traits<member_type<Idx> >;
+      constexpr member_type<Idx> stubs[] = {&traits::template stub<&resolve_lazy<Slot, Idx> >...};
+      return stubs[idx];
+    }(slot, std::make_index_sequence<lazy_slots>{});
+  }
+
+  template <std::size_t Idx>
+  using pointer_type = typename _impl::optional_symbol<member_type<Idx> >::type;
+
+  template <std::size_t Slot, std::size_t Idx>
+  static pointer_type<Idx> probe_target() {
+    auto const& member = reflection::symbol_at<Idx>(slot_owner<Slot, Idx>()->targets);
+    if constexpr (_impl::optional_symbol<member_type<Idx> >::value) {
+      return member.get();
+    } else {
+      return member;
+    }
+  }
+
+  template <std::size_t Idx>
+  static void record_call(std::chrono::steady_clock::duration elapsed) {
+    call_counters::record(Idx, static_cast<std::uint64_t>(std::chrono::nanoseconds(elapsed).count()));
+  }
+
+  template <std::size_t Idx>
+  static pointer_type<Idx> probe(std::size_t slot) {
+    return []<std::size_t... Slot>(std::size_t idx, std::index_sequence<Slot...>) {
+      using traits                        = policy_impl::stub_traits<pointer_type<Idx> >;
+      constexpr pointer_type<Idx> probes[] = {
+          &traits::template probe<&probe_target<Slot, Idx>, &record_call<Idx> >...};
+      return probes[idx];
+    }(slot, std::make_index_sequence<instrumented_slots>{});
+  }
+
+  // keeps the resolved symbols for the probes and exposes the probes instead
+  void instrument() {
+    targets = symbols;
+    reflection::for_each_symbol(symbols, [&]<std::size_t Idx>(auto& member) {
+      using T = std::remove_cvref_t<decltype(member)>;
+      if constexpr (policy_impl::stub_traits<pointer_type<Idx> >::stubbable) {
+        if constexpr (_impl::optional_symbol<T>::value) {
+          if (member) {
+            member = T{probe<Idx>(slot)};
+          }
+        } else {
+          member = probe<Idx>(slot);
+        }
+      }
+    });
+  }
+
+  // lazy instances beyond the last slot resolve eagerly instead, probes cannot do without one
+  static std::size_t acquire_slot(Library* owner) {
+    for (std::size_t idx = 0; idx < slot_count; ++idx) {
+      Library* expected = nullptr;
+      if (slot_owners[idx].compare_exchange_strong(expected, owner, std::memory_order_acq_rel)) {
+        return idx;
+      }
+    }
+    if constexpr (is_lazy) {
+      return no_slot;
+    } else {
+      throw LibraryError("too many live instrumented instances of this Library type");
+    }
+  }
+
+  void release_slot() {
+    if (slot != no_slot) {
+      slot_owners[slot].store(nullptr, std::memory_order_release);
+      slot = no_slot;
+    }
+  }
+
+  template <typename T>
+  static T to_member(platform::symbol_type symbol) {
+    if constexpr (_impl::optional_symbol<T>::value) {
+      return T{symbol_cast<typename _impl::optional_symbol<T>::type>(symbol)};
+    } else {
+      return symbol_cast<T>(symbol);
+    }
+  }
+
+  // with `variants` the most capable variant `level` allows, otherwise the plain name
+  // `local` is set if the object's own table had the symbol, see `SymbolResolver::find`
+  template <std::size_t Idx>
+  static platform::symbol_type find_symbol(platform::SymbolResolver const& resolver,
+                                           [[maybe_unused]] CpuLevel level,
+                                           bool* local = nullptr) noexcept {
+    if constexpr (is_variants) {
+      auto const& names  = variant_impl::cnames<Wrapper>[Idx];
+      auto const& hashes = variant_impl::hashes<Wrapper>[Idx];
+      // misses go through the loader only if the object itself exports no variant, ie. one from a dependency
+      for (auto idx = static_cast<std::size_t>(level) + 1; idx-- > 0;) {
+        if (auto symbol = resolver.find_local(names[idx], hashes[idx])) {
+          if (local != nullptr) {
+            *local = true;
+          }
+          return symbol;
+        }
+      }
+      for (auto idx = static_cast<std::size_t>(level) + 1; idx-- > 0;) {
+        if (auto symbol = resolver.find(names[idx], hashes[idx], local)) {
+          return symbol;
+        }
+      }
+      return nullptr;
+    } else {
+      return resolver.find(reflection::symbol_cnames<Wrapper>[Idx], reflection::symbol_hashes<Wrapper>[Idx], local);
+    }
+  }
+
+  // resolves every member in one pass and reports all missing required symbols at once
+  // `addresses` receives every resolved address in member order, 0 for stubbed or missing members and all bits set
+  // for symbols only the loader's search found
+  // collecting `addresses` resolves every member, stubs would leave holes in the cache entry
+  void load_symbols(LoadStats* stats, CpuLevel level, std::uintptr_t* addresses = nullptr) {
+    auto resolver = platform::SymbolResolver(handle);
+    std::size_t missing[reflection::symbol_count<Wrapper> + 1];
+    std::size_t missing_count = 0;
+
+    reflection::for_each_symbol(symbols, [&]<std::size_t Idx>(auto& member) {
+      using T = std::remove_cvref_t<decltype(member)>;
+      if constexpr (is_lazy && policy_impl::stub_traits<T>::stubbable) {
+        if (slot != no_slot && addresses == nullptr) {
+          member = lazy_stub<Idx>(slot);
+          return;
+        }
+      }
+
+      auto start  = stats == nullptr ? LoadStats::clock::time_point{} : LoadStats::clock::now();
+      bool local  = false;
+      auto symbol = find_symbol<Idx>(resolver, level, &local);
+      if (stats != nullptr) {
+        stats->symbols.push_back({reflection::symbol_names<Wrapper>[Idx], start, LoadStats::clock::now() - start});
+      }
+
+      if (addresses != nullptr) {
+        addresses[Idx] = symbol == nullptr ? 0 : (local ? reinterpret_cast<std::uintptr_t>(symbol) : ~std::uintptr_t{0});
+      }
+
+      if (symbol != nullptr) {
+        member = to_member<T>(symbol);
+      } else if constexpr (!_impl::optional_symbol<T>::value) {
+        missing[missing_count++] = Idx;
+      }
+    });
+
+    if (missing_count != 0) {
+      if (stats != nullptr) {
+        stats->failure = LoadStats::Failure{missing[0], reflection::symbol_names<Wrapper>[missing[0]]};
+      }
+      throw_missing(missing, missing_count);
+    }
+  }
+
+#if ERL_HAS_ELF_LOOKUP
+  // warm starts rebase the stored offsets, cold starts resolve as usual and store offsets for the next process
+  void load_cached(LoadStats* stats, CpuLevel level) {
+    constexpr std::size_t count = reflection::symbol_count<Wrapper>;
+    // other levels bind other variants, so each gets an entry of its own
+    auto const signature = is_variants ? cache_impl::fnv1a(cache_impl::signature<Wrapper>,
+                                                           variant_impl::suffixes[static_cast<std::size_t>(level)])
+                                       : cache_impl::signature<Wrapper>;
+
+    auto object            = cache_impl::Object{};
+    auto const& directory  = cache_impl::get_directory();
+    if (directory.empty() || !cache_impl::identify(handle, object)) {
+      load_symbols(stats, level);
+      return;
+    }
+
+    if (auto const* stored = cache_impl::lookup(directory, object, signature, count);
+        stored != nullptr && rebase(object, stored)) {
+      if (stats != nullptr) {
+        stats->cached = true;
+      }
+      return;
+    }
+
+    std::uintptr_t addresses[count + 1]{};
+    load_symbols(stats, level, addresses);
+    auto offsets = std::make_unique<std::uint64_t[]>(count + 1);
+    for (std::size_t idx = 0; idx < count; ++idx) {
+      if (addresses[idx] == 0) {
+        offsets[idx] = cache_impl::missing;
+      } else if (object.contains(addresses[idx])) {
+        offsets[idx] = addresses[idx] - object.base;
+      } else {
+        // defined by another object, which can move independently between runs, or not found through the object's
+        // own table, ie. IFUNC targets the loader picks per CPU
+        return;
+      }
+    }
+    cache_impl::write(cache_impl::file_path(directory, object, signature), object, signature, offsets.get(), count);
+    cache_impl::Memo::remember(directory, object, signature, offsets.release());
+  }
+
+  bool rebase(cache_impl::Object const& object, std::uint64_t const* offsets) {
+    bool complete = true;
+    reflection::for_each_symbol(symbols, [&]<std::size_t Idx>(auto& member) {
+      using T = std::remove_cvref_t<decltype(member)>;
+      if constexpr (is_lazy && policy_impl::stub_traits<T>::stubbable) {
+        if (slot != no_slot) {
+          member = lazy_stub<Idx>(slot);
+          return;
+        }
+      }
+      if (offsets[Idx] != cache_impl::missing && offsets[Idx] < object.end - object.base) {
+        member = to_member<T>(reinterpret_cast<platform::symbol_type>(object.base + offsets[Idx]));
+      } else if constexpr (!_impl::optional_symbol<T>::value) {
+        complete = false;
+      }
+    });
+    return complete;
+  }
+#endif
+
+  void resolve(LoadStats* stats) {
+    auto const level = is_variants ? cpu_level() : CpuLevel::baseline;
+#if ERL_HAS_ELF_LOOKUP
+    if constexpr (is_cached) {
+      load_cached(stats, level);
+      return;
+    }
+#endif
+    load_symbols(stats, level);
+  }
+
+  [[noreturn]] void throw_missing(std::size_t const* missing, std::size_t count) const {
+    std::vector<std::string_view> names;
+    names.reserve(count);
+    for (std::size_t idx = 0; idx < count; ++idx) {
+      names.push_back(reflection::symbol_names<Wrapper>[missing[idx]]);
+    }
+    throw MissingSymbolError(platform::library_path(handle), std::move(names));
+  }
+
+  void warm_up([[maybe_unused]] LoadStats* stats) {
+#if ERL_HAS_ELF_LOOKUP
+    if constexpr (is_huge_text) {
+      auto start = stats == nullptr ? LoadStats::clock::time_point{} : LoadStats::clock::now();
+      auto moved = platform::remap_text_to_huge_pages(handle);
+      if (stats != nullptr) {
+        stats->huge_text_bytes = moved;
+        stats->huge_text_time  = LoadStats::clock::now() - start;
+      }
+    }
+    if constexpr (prefault_mode != 0) {
+      auto start  = stats == nullptr ? LoadStats::clock::time_point{} : LoadStats::clock::now();
+      auto report = platform::prefault(handle, (prefault_mode & 2U) != 0);
+      if (stats != nullptr) {
+        stats->prefaulted_bytes = report.bytes;
+        stats->locked_bytes     = report.locked;
+        stats->prefault_time    = LoadStats::clock::now() - start;
+      }
+    }
+#endif
+  }
+
+  void initialize(LoadStats* stats = nullptr) {
+    try {
+      if constexpr (slot_count != 0) {
+        slot = acquire_slot(this);
+      }
+      warm_up(stats);
+
+      if (stats == nullptr) {
+        resolve(nullptr);
+      } else {
+        auto start = LoadStats::clock::now();
+        stats->symbols.reserve(reflection::symbol_count<Wrapper>);
+        resolve(stats);
+        stats->resolve_time = LoadStats::clock::now() - start;
+      }
+
+      if constexpr (is_instrumented) {
+        instrument();
+      }
+#if ERL_HAS_ELF_LOOKUP
+      if constexpr (is_reverse_lookup) {
+        index = platform::elf::AddressIndex(handle);
+      }
+#endif
+    } catch (...) {
+      release_slot();
+      platform::unload_library(handle);
+      throw;
+    }
+  }
+
+  static platform::handle_type open_handle(char const* path) {
+#if ERL_HAS_DLMOPEN
+    if constexpr (is_isolated) {
+      return platform::load_isolated_library(path, loader_flags);
+    }
+#endif
+    return platform::load_library(path, loader_flags);
+  }
+
+  void load(char const* path, LoadStats* stats) {
+    if (stats == nullptr) {
+      handle = open_handle(path);
+    } else {
+      auto start       = LoadStats::clock::now();
+      handle           = open_handle(path);
+      stats->open_time = LoadStats::clock::now() - start;
+    }
+    initialize(stats);
+  }
+
+  void share(char const* path, LoadStats* stats) {
+    entry = &registry::acquire(path, [&](registry_impl::Entry<Wrapper>& closed) {
+      load(path, stats);
+      closed.handle  = handle;
+      closed.symbols = symbols;
+    });
+    handle  = entry->handle;
+    symbols = entry->symbols;
+  }
+
+  void open(char const* path, LoadStats* stats) {
+    auto lease     = _impl::ObserverLease{};
+    auto* observer = lease.get();
+    if (stats == nullptr && observer == nullptr) {
+      if constexpr (is_shared) {
+        share(path, nullptr);
+      } else {
+        load(path, nullptr);
+      }
+      seal_table();
+      return;
+    }
+
+    auto local = std::optional<LoadStats>{};
+    if (stats == nullptr) {
+      stats = &local.emplace();
+    }
+    stats->path         = path;
+    stats->start        = LoadStats::clock::now();
+    stats->symbol_count = reflection::symbol_count<Wrapper>;
+
+    try {
+      if constexpr (is_shared) {
+        share(path, stats);
+      } else {
+        load(path, stats);
+      }
+      seal_table();
+    } catch (std::exception const& exc) {
+      stats->error = exc.what();
+      if (observer != nullptr) {
+        observer->on_load(*stats);
+      }
+      throw;
+    }
+
+    if (observer != nullptr) {
+      observer->on_load(*stats);
+    }
+  }
+
+  void seal_table() {
+    if constexpr (is_sealed) {
+      auto const* copy = platform::map_read_only(&symbols, sizeof(Wrapper), seal_offset);
+      if (copy == nullptr) {
+        release();
+        throw LibraryError("could not map the sealed symbol table");
+      }
+      sealed_table = static_cast<Wrapper const*>(copy);
+    }
+  }
+
+  void release() noexcept {
+    release_slot();
+    if constexpr (is_sealed) {
+      if (sealed_table != nullptr) {
+        platform::unmap_read_only(sealed_table, sizeof(Wrapper), seal_offset);
+        sealed_table = nullptr;
+      }
+    }
+    if constexpr (is_shared) {
+      if (entry != nullptr) {
+        registry::release(*entry);
+        entry = nullptr;
+      }
+    } else if (handle != nullptr) {
+      platform::unload_library(handle);
+    }
+#if ERL_HAS_MEMFD
+    if (image >= 0) {
+      ::close(image);
+      image = -1;
+    }
+#endif
+  }
+
+public:
+  /// Neither constructor allocates unless loading fails, the library is shared or a `LoadObserver` is installed.
+  explicit Library(char const* path) : handle{nullptr}, symbols{} { open(path, nullptr); }
+  explicit Library(std::string_view path) : handle{nullptr}, symbols{} {
+    platform::_impl::with_c_str(path, [&](char const* str) { open(str, nullptr); });
+  }
+
+  /// Fills in `stats` while loading, even if loading fails.
+  Library(char const* path, LoadStats& stats) : handle{nullptr}, symbols{} { open(path, &stats); }
+  Library(std::string_view path, LoadStats& stats) : handle{nullptr}, symbols{} {
+    platform::_impl::with_c_str(path, [&](char const* str) { open(str, &stats); });
+  }
+
+  /// Takes ownership of `handle`, which is closed again if resolving fails.
+  Library(adopt_handle_t, platform::handle_type handle)
+    requires(!is_shared)
+      : handle{handle}, symbols{} {
+    initialize();
+    seal_table();
+  }
+
+#if ERL_HAS_MEMFD
+  /// Loads a library image from memory, ie. a plugin embedded in the executable, without writing it to disk.
+  explicit Library(std::span<std::byte const> contents)
+    requires(!is_shared)
+      : handle{nullptr}, symbols{} {
+    auto file = platform::MemoryImage(contents);
+    open(file.path(), nullptr);
+    image = file.release();
+  }
+
+  /// Loads the library image readable through `fd`, which may be a pipe or socket. `fd` is not closed.
+  Library(from_fd_t, int fd)
+    requires(!is_shared)
+      : handle{nullptr}, symbols{} {
+    auto file = platform::MemoryImage(fd);
+    open(file.path(), nullptr);
+    image = file.release();
+  }
+#endif
+
+  ~Library() { release(); }
+
+  Library(Library const&)            = delete;
+  Library& operator=(Library const&) = delete;
+
+  Library(Library&& other) noexcept
+      : handle(other.handle)
+      , symbols(other.symbols)
+      , slot(other.slot)
+      , entry(other.entry)
+      , targets(other.targets)
+#if ERL_HAS_ELF_LOOKUP
+      , index(std::move(other.index))
+#endif
+      , sealed_table(std::exchange(other.sealed_table, {})) {
+    if (slot != no_slot) {
+      slot_owners[slot].store(this, std::memory_order_release);
+    }
+    other.handle  = nullptr;
+    other.symbols = {};
+    other.slot    = no_slot;
+    other.entry   = {};
+#if ERL_HAS_MEMFD
+    image = std::exchange(other.image, -1);
+#endif
+  }
+
+  Library& operator=(Library&& other) noexcept {
+    if (this != &other) {
+      std::swap(symbols, other.symbols);
+      std::swap(handle, other.handle);
+      std::swap(slot, other.slot);
+      std::swap(entry, other.entry);
+      std::swap(targets, other.targets);
+#if ERL_HAS_ELF_LOOKUP
+      std::swap(index, other.index);
+#endif
+      std::swap(sealed_table, other.sealed_table);
+#if ERL_HAS_MEMFD
+      std::swap(image, other.image);
+#endif
+      if (slot != no_slot) {
+        slot_owners[slot].store(this, std::memory_order_release);
+      }
+      if (other.slot != no_slot) {
+        slot_owners[other.slot].store(&other, std::memory_order_release);
+      }
+    }
+    return *this;
+  }
+
+  /// Resolve every symbol that is still bound to its lazy stub.
+  /// Throws one `MissingSymbolError` listing every missing symbol, which allows reporting errors up front.
+  void resolve_all()
+    requires(is_lazy)
+  {
+    if (slot == no_slot) {
+      // resolved eagerly at construction
+      return;
+    }
+    auto resolver    = platform::SymbolResolver(handle);
+    auto const level = is_variants ? cpu_level() : CpuLevel::baseline;
+    std::size_t missing[reflection::symbol_count<Wrapper> + 1];
+    std::size_t missing_count = 0;
+
+    reflection::for_each_symbol(symbols, [&]<std::size_t Idx>(auto& member) {
+      using T = std::remove_cvref_t<decltype(member)>;
+      if constexpr (policy_impl::stub_traits<T>::stubbable) {
+        if (member != lazy_stub<Idx>(slot)) {
+          return;
+        }
+        if (auto symbol = find_symbol<Idx>(resolver, level)) {
+          member = symbol_cast<T>(symbol);
+        } else {
+          missing[missing_count++] = Idx;
+        }
+      }
+    });
+
+    if (missing_count != 0) {
+      throw_missing(missing, missing_count);
+    }
+  }
+
+  /// One entry per symbol in member order, with the calls made through every instance of this `Library` type so far.
+  /// The counters are static, so the totals outlive the instances and cannot be split by instance.
+  /// Threads that exited are included. Counts stay zero if `ERL_INSTRUMENTATION` is false.
+  [[nodiscard]] static std::vector<CallStats> call_stats()
+    requires(instrumented_slots != 0)
+  {
+    auto result = std::vector<CallStats>(reflection::symbol_count<Wrapper>);
+    for (std::size_t idx = 0; idx < result.size(); ++idx) {
+      result[idx].name = reflection::symbol_names<Wrapper>[idx];
+    }
+    if constexpr (is_instrumented) {
+      call_counters::merge(result);
+    }
+    return result;
+  }
+
+#if ERL_HAS_ELF_LOOKUP
+  /// Address ranges of every function in the library, built at load time. Lookups are async-signal-safe.
+  [[nodiscard]] platform::elf::AddressIndex const& address_index() const noexcept
+    requires(is_reverse_lookup)
+  {
+    return index;
+  }
+#endif
+
+  [[nodiscard]] platform::handle_type native_handle() const noexcept { return handle; }
+
+  Wrapper const& operator*() const { return *operator->(); }
+  Wrapper const* operator->() const {
+    if constexpr (is_sealed) {
+      return sealed_table;
+    } else {
+      return &symbols;
+    }
+  }
 };
 
 }  // namespace erl
 
-#undef ERL_HAS_REFLECTION
\ No newline at end of file
+#undef ERL_HAS_REFLECTION
@@ -0,0 +1,314 @@
+/*
+MIT License
+
+Copyright (c) 2025 Tsche
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#pragma once
+#include <atomic>
+#include <cassert>
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <semaphore>
+#include <stop_token>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include <autoload.hpp>
+
+namespace erl {
+
+/// Reported by `LoadTask::get` and `co_await` once a load was cancelled.
+struct LoadCancelled : LibraryError {
+  LoadCancelled() : LibraryError("library load cancelled") {}
+};
+
+/// Default executor of `load_async`, one background thread running loads in submission order.
+/// The loader serializes `dlopen` anyway, so more threads would only contend for its lock.
+/// Jobs still queued on destruction are run before the thread exits.
+class BackgroundExecutor {
+  std::mutex mutex;
+  std::deque<std::move_only_function<void()> > jobs;
+  // released once per job and once more when stopping
+  std::counting_semaphore<> pending{0};
+  std::thread worker;
+
+  void run() {
+    while (true) {
+      pending.acquire();
+      auto lock = std::unique_lock(mutex);
+      if (jobs.empty()) {
+        return;
+      }
+      auto job = std::move(jobs.front());
+      jobs.pop_front();
+      lock.unlock();
+      job();
+    }
+  }
+
+public:
+  BackgroundExecutor() = default;
+  BackgroundExecutor(BackgroundExecutor const&)            = delete;
+  BackgroundExecutor& operator=(BackgroundExecutor const&) = delete;
+
+  ~BackgroundExecutor() {
+    if (worker.joinable()) {
+      pending.release();
+      worker.join();
+    }
+  }
+
+  void operator()(std::move_only_function<void()> job) {
+    {
+      auto lock = std::lock_guard(mutex);
+      jobs.push_back(std::move(job));
+      // started on first use, programs that never load asynchronously do not pay for the thread
+      if (!worker.joinable()) {
+        worker = std::thread([this] { run(); });
+      }
+    }
+    pending.release();
+  }
+};
+
+inline BackgroundExecutor& background_executor() {
+  static BackgroundExecutor executor;
+  return executor;
+}
+
+/// Anything `load_async` can hand a job to, ie. a thread pool's `post`. Jobs must run exactly once, on any thread.
+template <typename E>
+concept LoadExecutor = std::invocable<E&, std::move_only_function<void()> >;
+
+namespace async_impl {
+template <typename L>
+struct State {
+  enum class Stage { pending, running, done };
+
+  std::mutex mutex;
+  std::atomic<bool> finished{false};
+  Stage stage = Stage::pending;
+  bool cancelled = false;
+  std::optional<L> library;
+  std::exception_ptr error;
+  // set by a suspended awaiter, either resumes it inline or hands it to the executor it asked for
+  std::move_only_function<void()> waiter;
+
+  struct CancelOnStop {
+    State* state;
+    void operator()() const { state->cancel(); }
+  };
+  // declared last so it is deregistered before anything it could touch is destroyed
+  std::optional<std::stop_callback<CancelOnStop> > on_stop;
+
+  // calls the waiter outside the lock, on the completing thread
+  void complete(std::unique_lock<std::mutex>& lock) {
+    stage       = Stage::done;
+    auto resume = std::exchange(waiter, nullptr);
+    lock.unlock();
+    finished.store(true, std::memory_order_release);
+    finished.notify_all();
+    if (resume) {
+      resume();
+    }
+  }
+
+  void run(std::string const& path) {
+    auto lock = std::unique_lock(mutex);
+    if (stage != Stage::pending) {
+      return;
+    }
+    stage = Stage::running;
+    lock.unlock();
+
+    auto loaded = std::optional<L>{};
+    auto failed = std::exception_ptr{};
+    try {
+      loaded.emplace(path.c_str());
+    } catch (...) {
+      failed = std::current_exception();
+    }
+
+    lock.lock();
+    if (cancelled) {
+      // unloaded right away, nobody can observe it anymore
+      lock.unlock();
+      loaded.reset();
+      lock.lock();
+      error = std::make_exception_ptr(LoadCancelled{});
+    } else {
+      library = std::move(loaded);
+      error   = failed;
+    }
+    complete(lock);
+  }
+
+  void cancel() {
+    auto lock = std::unique_lock(mutex);
+    if (stage == Stage::done) {
+      return;
+    }
+    cancelled = true;
+    if (stage == Stage::pending) {
+      error = std::make_exception_ptr(LoadCancelled{});
+      complete(lock);
+    }
+  }
+};
+}  // namespace async_impl
+
+/// Handle to a library being loaded in the background, see `load_async`.
+/// Either call `get` or `co_await` it (once), the result is the loaded `Library` or the exception loading threw.
+/// Dropping the handle does not cancel the load, the library is unloaded again once it finishes.
+///
+/// A plain `co_await` resumes the coroutine on whichever thread finished the load, for the default executor
+/// that is its only worker. Until the coroutine suspends again no other queued load makes progress, and
+/// blocking on another `load_async(...).get()` from there deadlocks. Use `co_await task.resume_on(executor)`
+/// to continue elsewhere.
+template <typename Wrapper, typename... Policies>
+class LoadTask {
+public:
+  using library_type = Library<Wrapper, Policies...>;
+
+private:
+  using state_type = async_impl::State<library_type>;
+  std::shared_ptr<state_type> state;
+
+  template <typename W, typename... P, typename E>
+    requires LoadExecutor<E>
+  friend LoadTask<W, P...> load_async(std::string path, E& executor, std::stop_token stop);
+
+  explicit LoadTask(std::shared_ptr<async_impl::State<library_type> > state_) : state(std::move(state_)) {}
+
+  library_type take() {
+    auto current = std::exchange(state, nullptr);
+    auto lock    = std::lock_guard(current->mutex);
+    if (current->error) {
+      std::rethrow_exception(current->error);
+    }
+    return std::move(*current->library);
+  }
+
+  // the awaiting coroutine is parked in the state until the load completes, `Resume` decides where it continues
+  template <typename Resume>
+  struct BasicAwaiter {
+    LoadTask& task;
+    [[no_unique_address]] Resume resume;
+
+    bool await_ready() const { return task.ready(); }
+
+    bool await_suspend(std::coroutine_handle<> handle) {
+      auto lock = std::lock_guard(task.state->mutex);
+      if (task.state->stage == state_type::Stage::done) {
+        return false;
+      }
+      task.state->waiter = [resume = std::move(resume), handle]() mutable { resume(handle); };
+      return true;
+    }
+
+    library_type await_resume() { return task.take(); }
+  };
+
+  struct Inline {
+    void operator()(std::coroutine_handle<> handle) const { handle.resume(); }
+  };
+
+  template <typename Executor>
+  struct Post {
+    Executor* executor;
+    void operator()(std::coroutine_handle<> handle) const { (*executor)([handle] { handle.resume(); }); }
+  };
+
+public:
+  LoadTask(LoadTask const&)            = delete;
+  LoadTask& operator=(LoadTask const&) = delete;
+  LoadTask(LoadTask&&)                 = default;
+  LoadTask& operator=(LoadTask&&)      = default;
+  ~LoadTask()                          = default;
+
+  [[nodiscard]] bool valid() const noexcept { return state != nullptr; }
+
+  [[nodiscard]] bool ready() const {
+    assert(valid());
+    return state->finished.load(std::memory_order_acquire);
+  }
+
+  void wait() const {
+    assert(valid());
+    state->finished.wait(false, std::memory_order_acquire);
+  }
+
+  /// Blocks until loading finished and returns the library, or rethrows what loading threw.
+  library_type get() {
+    wait();
+    return take();
+  }
+
+  /// Loads that did not start yet are dropped and complete immediately, loads in progress are unloaded once
+  /// they finish. Either way `get` and `co_await` throw `LoadCancelled`. Has no effect once loading finished.
+  void cancel() {
+    assert(valid());
+    state->cancel();
+  }
+
+  using Awaiter = BasicAwaiter<Inline>;
+
+  // the coroutine resumes on the thread that finished or cancelled the load
+  Awaiter operator co_await() & noexcept { return Awaiter{*this, {}}; }
+  Awaiter operator co_await() && noexcept { return Awaiter{*this, {}}; }
+
+  /// Awaitable that continues the coroutine as a job on `executor` instead of on the completing thread.
+  /// Does not hop if the load already finished when awaited.
+  template <typename Executor>
+    requires LoadExecutor<Executor>
+  BasicAwaiter<Post<Executor> > resume_on(Executor& executor) & noexcept {
+    return {*this, {&executor}};
+  }
+};
+
+/// Opens `path` and resolves `Wrapper` on `executor`, so loading overlaps with whatever the caller does meanwhile.
+/// ie. `auto gl = erl::load_async<Gl>("libGL.so.1"); parse_config(); auto lib = gl.get();`
+/// Requesting a stop on `stop` cancels the load as `LoadTask::cancel` would, on the requesting thread.
+template <typename Wrapper, typename... Policies, typename Executor>
+  requires LoadExecutor<Executor>
+LoadTask<Wrapper, Policies...> load_async(std::string path, Executor& executor, std::stop_token stop = {}) {
+  using library_type = Library<Wrapper, Policies...>;
+  using state_type   = async_impl::State<library_type>;
+  auto state         = std::make_shared<state_type>();
+  if (stop.stop_possible()) {
+    state->on_stop.emplace(std::move(stop), typename state_type::CancelOnStop{state.get()});
+  }
+  executor([state, path = std::move(path)] { state->run(path); });
+  return LoadTask<Wrapper, Policies...>(std::move(state));
+}
+
+template <typename Wrapper, typename... Policies>
+LoadTask<Wrapper, Policies...> load_async(std::string path, std::stop_token stop = {}) {
+  return load_async<Wrapper, Policies...>(std::move(path), background_executor(), std::move(stop));
+}
+}  // namespace erl
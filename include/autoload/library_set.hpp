@@ -0,0 +1,273 @@
+/*
+MIT License
+
+Copyright (c) 2025 Tsche
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <semaphore>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <autoload.hpp>
+
+#if !(defined(_WIN32) || defined(_WIN64))
+#  include <fcntl.h>
+#  include <unistd.h>
+#endif
+
+namespace erl {
+
+/// Aggregated failure of a `LibrarySet`, listing every library that could not be loaded.
+struct LibrarySetError : LibraryError {
+  struct Failure {
+    std::size_t index;
+    std::string path;
+    std::string message;
+  };
+
+  std::vector<Failure> failures;
+
+  explicit LibrarySetError(std::vector<Failure> failures_)
+      : LibraryError(describe(failures_))
+      , failures(std::move(failures_)) {}
+
+private:
+  static std::string describe(std::vector<Failure> const& failures) {
+    auto message = "failed to load " + std::to_string(failures.size()) + " libraries";
+    for (auto const& failure : failures) {
+      message += "\n  [" + std::to_string(failure.index) + "] " + failure.path + ": " + failure.message;
+    }
+    return message;
+  }
+};
+
+namespace _impl {
+// helper threads for `parallel_for`, started on first use and kept until exit
+class WorkerPool {
+  std::mutex busy;
+  // released once per helper taking part in a job, and once per helper when stopping
+  std::counting_semaphore<> wake{0};
+  std::atomic<std::size_t> running{0};
+  std::atomic<bool> stopping{false};
+  void (*job)(void*) = nullptr;
+  void* context      = nullptr;
+  std::vector<std::thread> threads;
+
+  void run() {
+    while (true) {
+      wake.acquire();
+      if (stopping.load(std::memory_order_acquire)) {
+        return;
+      }
+      job(context);
+      if (running.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        running.notify_one();
+      }
+    }
+  }
+
+public:
+  explicit WorkerPool(std::size_t helpers) {
+    threads.reserve(helpers);
+    for (std::size_t idx = 0; idx < helpers; ++idx) {
+      threads.emplace_back([this] { run(); });
+    }
+  }
+  WorkerPool(WorkerPool const&)            = delete;
+  WorkerPool& operator=(WorkerPool const&) = delete;
+
+  ~WorkerPool() {
+    stopping.store(true, std::memory_order_release);
+    wake.release(static_cast<std::ptrdiff_t>(threads.size()));
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+
+  [[nodiscard]] std::size_t size() const noexcept { return threads.size(); }
+
+  // runs fnc() on the calling thread and on up to `helpers` pooled ones, returns once all of them finished
+  // only one caller uses the helpers at a time, false if another one currently holds them
+  template <typename F>
+  bool try_run(std::size_t helpers, F& fnc) {
+    auto lock = std::unique_lock(busy, std::try_to_lock);
+    if (!lock.owns_lock()) {
+      return false;
+    }
+    helpers = std::min(helpers, threads.size());
+    job     = [](void* fnc_) { (*static_cast<F*>(fnc_))(); };
+    context = &fnc;
+    running.store(helpers, std::memory_order_relaxed);
+    wake.release(static_cast<std::ptrdiff_t>(helpers));
+
+    fnc();
+    for (auto left = running.load(std::memory_order_acquire); left != 0; left = running.load(std::memory_order_acquire)) {
+      running.wait(left, std::memory_order_acquire);
+    }
+    return true;
+  }
+};
+
+inline WorkerPool& worker_pool() {
+  static auto pool = WorkerPool(std::max(1U, std::thread::hardware_concurrency()) - 1);
+  return pool;
+}
+
+// runs fnc(idx) for every idx in [0, count) on up to hardware_concurrency threads, including the calling one
+// concurrent calls run on the calling thread alone while another one uses the pool. fnc must not throw
+template <typename F>
+void parallel_for(std::size_t count, F&& fnc) {
+  auto next   = std::atomic<std::size_t>{0};
+  auto worker = [&] {
+    for (auto idx = next.fetch_add(1, std::memory_order_relaxed); idx < count;
+         idx      = next.fetch_add(1, std::memory_order_relaxed)) {
+      fnc(idx);
+    }
+  };
+
+  if (count <= 1 || !worker_pool().try_run(count - 1, worker)) {
+    worker();
+  }
+}
+
+// asks the kernel to start reading the file so dlopen finds it in the page cache
+inline void prefetch_file([[maybe_unused]] char const* path) noexcept {
+#if !(defined(_WIN32) || defined(_WIN64))
+  // bare names are searched for by the loader, only explicit paths can be prefetched
+  if (std::strchr(path, '/') == nullptr) {
+    return;
+  }
+
+  int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return;
+  }
+  ::posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+  ::close(fd);
+#endif
+}
+}  // namespace _impl
+
+/// Loads several libraries at once.
+/// File reads are prefetched in parallel, the `dlopen` calls - which the loader serializes anyway - are issued as
+/// one batch from the calling thread and symbols are resolved in parallel again.
+/// If any library fails to load, every other one is closed again and a single `LibrarySetError` is thrown.
+template <typename... Wrappers>
+class LibrarySet {
+  static constexpr std::size_t count = sizeof...(Wrappers);
+
+  std::tuple<std::optional<Library<Wrappers> >...> libraries;
+
+  template <std::size_t... Idx>
+  void adopt(std::size_t idx, platform::handle_type handle, std::index_sequence<Idx...>) {
+    (void)((idx == Idx ? (std::get<Idx>(libraries).emplace(adopt_handle, handle), true) : false) || ...);
+  }
+
+  void load(std::array<std::string, count> const& paths) {
+    std::array<platform::handle_type, count> handles{};
+    std::array<std::optional<std::string>, count> errors{};
+
+    _impl::parallel_for(count, [&](std::size_t idx) { _impl::prefetch_file(paths[idx].c_str()); });
+
+    for (std::size_t idx = 0; idx < count; ++idx) {
+      try {
+        handles[idx] = platform::load_library(paths[idx].c_str());
+      } catch (std::exception const& exc) {
+        errors[idx] = exc.what();
+      }
+    }
+
+    _impl::parallel_for(count, [&](std::size_t idx) {
+      if (handles[idx] == nullptr) {
+        return;
+      }
+      try {
+        adopt(idx, handles[idx], std::index_sequence_for<Wrappers...>{});
+      } catch (std::exception const& exc) {
+        errors[idx] = exc.what();
+      }
+    });
+
+    std::vector<LibrarySetError::Failure> failures;
+    for (std::size_t idx = 0; idx < count; ++idx) {
+      if (errors[idx].has_value()) {
+        failures.push_back({idx, paths[idx], std::move(*errors[idx])});
+      }
+    }
+
+    if (!failures.empty()) {
+      libraries = {};
+      throw LibrarySetError(std::move(failures));
+    }
+  }
+
+public:
+  template <typename... Paths>
+    requires(sizeof...(Paths) == count && (std::is_convertible_v<Paths const&, std::string_view> && ...))
+  explicit LibrarySet(Paths const&... paths) {
+    load({std::string{std::string_view{paths}}...});
+  }
+
+  [[nodiscard]] static constexpr std::size_t size() noexcept { return count; }
+
+  template <std::size_t Idx>
+  [[nodiscard]] auto& get() noexcept {
+    return *std::get<Idx>(libraries);
+  }
+
+  template <std::size_t Idx>
+  [[nodiscard]] auto const& get() const noexcept {
+    return *std::get<Idx>(libraries);
+  }
+
+  template <typename Wrapper>
+    requires((std::is_same_v<Wrapper, Wrappers> + ...) == 1)
+  [[nodiscard]] Library<Wrapper>& get() noexcept {
+    return *std::get<std::optional<Library<Wrapper> > >(libraries);
+  }
+
+  template <typename Wrapper>
+    requires((std::is_same_v<Wrapper, Wrappers> + ...) == 1)
+  [[nodiscard]] Library<Wrapper> const& get() const noexcept {
+    return *std::get<std::optional<Library<Wrapper> > >(libraries);
+  }
+};
+
+/// Convenience wrapper around `LibrarySet`, ie. `erl::load_all<Gl, Vk>("libGL.so.1", "libvulkan.so.1")`.
+template <typename... Wrappers, typename... Paths>
+  requires(sizeof...(Wrappers) == sizeof...(Paths))
+LibrarySet<Wrappers...> load_all(Paths const&... paths) {
+  return LibrarySet<Wrappers...>(paths...);
+}
+}  // namespace erl
@@ -0,0 +1,310 @@
+/*
+MIT License
+
+Copyright (c) 2025 Tsche
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <autoload.hpp>
+#include <autoload/library_set.hpp>
+
+#if ERL_HAS_ELF_LOOKUP
+#  include <link.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+namespace erl {
+
+/// Result of `scan_plugins`, every library in a directory that exports the symbols `Wrapper` requires.
+template <typename Wrapper, typename... Policies>
+struct PluginScan {
+  struct Plugin {
+    std::filesystem::path path;
+    Library<Wrapper, Policies...> library;
+  };
+
+  /// A candidate that exported every required symbol but still failed to load.
+  struct Failure {
+    std::filesystem::path path;
+    std::string message;
+  };
+
+  /// Sorted by path.
+  std::vector<Plugin> plugins;
+  std::vector<Failure> failures;
+
+  std::size_t candidates = 0;
+  /// Candidates lacking a required symbol, never opened.
+  std::size_t rejected = 0;
+  /// Candidates whose symbol check was answered by the manifest.
+  std::size_t unchanged = 0;
+};
+
+namespace plugin_impl {
+#if ERL_HAS_ELF_LOOKUP
+// true if the dynamic symbol table of the ELF file at `path` defines every name in `required`, which must be sorted
+// and free of duplicates
+// every name that satisfies a required member, sorted by name, with the index of the member it satisfies
+struct Requirements {
+  std::vector<std::pair<std::string_view, std::size_t> > names;
+  std::size_t members = 0;
+};
+
+inline bool exports_all(char const* path, Requirements const& required) {
+  auto found = std::vector<char>(required.members, 0);
+  platform::elf::with_file_symbols(
+      path, SHT_DYNSYM, [&](std::span<ElfW(Sym) const> symbols, char const* strings, std::size_t strings_size) {
+        for (auto const& sym : symbols) {
+          auto binding = ELF64_ST_BIND(sym.st_info);
+          if (sym.st_shndx == SHN_UNDEF || sym.st_name >= strings_size ||
+              (binding != STB_GLOBAL && binding != STB_WEAK && binding != STB_GNU_UNIQUE)) {
+            continue;
+          }
+          // versioned duplicates of one name only count once
+          auto name = std::string_view{strings + sym.st_name};
+          for (auto const& [_, member] : std::ranges::equal_range(required.names, name, {},
+                                                                   &std::pair<std::string_view, std::size_t>::first)) {
+            found[member] = 1;
+          }
+        }
+      });
+  return std::ranges::count(found, 1) == static_cast<std::ptrdiff_t>(required.members);
+}
+
+struct Stamp {
+  std::uint64_t device;
+  std::uint64_t inode;
+  std::int64_t mtime;
+  std::uint64_t size;
+
+  friend bool operator==(Stamp const&, Stamp const&) = default;
+};
+
+inline std::optional<Stamp> stamp(char const* path) {
+  struct stat info {};
+  if (::stat(path, &info) != 0) {
+    return std::nullopt;
+  }
+  return Stamp{static_cast<std::uint64_t>(info.st_dev), static_cast<std::uint64_t>(info.st_ino),
+               std::int64_t{info.st_mtim.tv_sec} * 1'000'000'000 + info.st_mtim.tv_nsec,
+               static_cast<std::uint64_t>(info.st_size)};
+}
+
+struct Verdict {
+  Stamp stamp;
+  bool matches;
+};
+
+inline constexpr std::string_view manifest_magic = "erl-plugins-1";
+
+// one line per candidate: device inode mtime size matches name. Entries from another interface are discarded
+inline std::unordered_map<std::string, Verdict> read_manifest(std::filesystem::path const& path,
+                                                              std::uint64_t signature) {
+  auto result = std::unordered_map<std::string, Verdict>{};
+  auto file   = std::ifstream(path);
+  auto magic  = std::string{};
+  auto stored = std::uint64_t{};
+  if (!(file >> magic >> std::hex >> stored >> std::dec) || magic != manifest_magic || stored != signature) {
+    return result;
+  }
+
+  auto entry = Verdict{};
+  auto name  = std::string{};
+  while (file >> entry.stamp.device >> entry.stamp.inode >> entry.stamp.mtime >> entry.stamp.size >> entry.matches &&
+         file.get() == ' ' && std::getline(file, name)) {
+    result.insert_or_assign(name, entry);
+  }
+  return result;
+}
+
+inline void write_manifest(std::filesystem::path const& path, std::uint64_t signature,
+                           std::vector<std::pair<std::string, Verdict> > const& entries) {
+  auto temporary = path;
+  temporary += ".tmp" + std::to_string(::getpid());
+  {
+    auto file = std::ofstream(temporary, std::ios::trunc);
+    file << manifest_magic << ' ' << std::hex << signature << std::dec << '\n';
+    for (auto const& [name, entry] : entries) {
+      file << entry.stamp.device << ' ' << entry.stamp.inode << ' ' << entry.stamp.mtime << ' ' << entry.stamp.size
+           << ' ' << entry.matches << ' ' << name << '\n';
+    }
+    if (!file.flush()) {
+      file.close();
+      std::filesystem::remove(temporary);
+      return;
+    }
+  }
+  // renamed into place, so concurrent scans never read a partial manifest
+  auto error = std::error_code{};
+  std::filesystem::rename(temporary, path, error);
+  if (error) {
+    std::filesystem::remove(temporary, error);
+  }
+}
+#endif
+
+// with `variants` any variant up to `level` satisfies a member, just as when loading
+template <typename Wrapper, bool Variants>
+Requirements required_symbols([[maybe_unused]] CpuLevel level) {
+  auto required = Requirements{};
+  auto probe    = Wrapper{};
+  reflection::for_each_symbol(probe, [&]<std::size_t Idx>(auto& member) {
+    if constexpr (!_impl::optional_symbol<std::remove_cvref_t<decltype(member)> >::value) {
+      if constexpr (Variants) {
+        for (std::size_t idx = 0; idx <= static_cast<std::size_t>(level); ++idx) {
+          required.names.emplace_back(variant_impl::cnames<Wrapper>[Idx][idx], required.members);
+        }
+      } else {
+        required.names.emplace_back(reflection::symbol_names<Wrapper>[Idx], required.members);
+      }
+      ++required.members;
+    }
+  });
+  std::ranges::sort(required.names);
+  return required;
+}
+}  // namespace plugin_impl
+
+/// Loads every `*.so` in `directory` that exports the symbols `Wrapper` requires.
+/// Readahead is issued for every candidate at once. Each candidate's dynamic symbol table is then checked
+/// without loading it, so libraries implementing other interfaces are never opened, and the matching ones are
+/// loaded in parallel. With a `manifest` path the outcome of the symbol check is stored keyed by device, inode,
+/// mtime and size, and later scans only inspect files that changed since. Candidates that fail to load are
+/// reported in `PluginScan::failures` instead of throwing.
+template <typename Wrapper, typename... Policies>
+PluginScan<Wrapper, Policies...> scan_plugins(std::filesystem::path const& directory,
+                                              std::filesystem::path const& manifest = {}) {
+  static_assert(policy_impl::instrumented_instances<Policies...> == 0,
+                "instrumented libraries are limited to a fixed number of live instances per type");
+  using library_type = Library<Wrapper, Policies...>;
+  auto result        = PluginScan<Wrapper, Policies...>{};
+
+  auto paths = std::vector<std::filesystem::path>{};
+  for (auto const& entry : std::filesystem::directory_iterator(directory)) {
+    if (entry.path().extension() == ".so" && entry.is_regular_file()) {
+      paths.push_back(entry.path());
+    }
+  }
+  std::ranges::sort(paths);
+  result.candidates = paths.size();
+
+  auto matches = std::vector<char>(paths.size(), 1);
+#if ERL_HAS_ELF_LOOKUP
+  constexpr bool is_variants = policy_impl::is_variants<Policies...>;
+  auto const level           = is_variants ? cpu_level() : CpuLevel::baseline;
+  // other levels accept other variants, so each keeps a manifest of its own
+  auto const signature = is_variants ? cache_impl::fnv1a(cache_impl::signature<Wrapper>,
+                                                         variant_impl::suffixes[static_cast<std::size_t>(level)])
+                                     : cache_impl::signature<Wrapper>;
+  auto known     = std::unordered_map<std::string, plugin_impl::Verdict>{};
+  auto verdicts  = std::vector<std::optional<plugin_impl::Verdict> >(paths.size());
+  auto pending   = std::vector<std::size_t>{};
+  auto changed   = std::vector<char>(paths.size(), 0);
+  if (!manifest.empty()) {
+    known = plugin_impl::read_manifest(manifest, signature);
+  }
+  for (std::size_t idx = 0; idx < paths.size(); ++idx) {
+    auto current = plugin_impl::stamp(paths[idx].c_str());
+    if (!current) {
+      matches[idx] = 0;
+      continue;
+    }
+    if (auto it = known.find(paths[idx].filename().string()); it != known.end() && it->second.stamp == *current) {
+      verdicts[idx] = it->second;
+      ++result.unchanged;
+    } else {
+      verdicts[idx] = plugin_impl::Verdict{*current, false};
+      changed[idx]  = 1;
+      pending.push_back(idx);
+    }
+  }
+
+  // files the manifest rejects are never read
+  _impl::parallel_for(paths.size(), [&](std::size_t idx) {
+    if (changed[idx] != 0 || (verdicts[idx] && verdicts[idx]->matches)) {
+      _impl::prefetch_file(paths[idx].c_str());
+    }
+  });
+
+  auto const required = plugin_impl::required_symbols<Wrapper, is_variants>(level);
+  _impl::parallel_for(pending.size(), [&](std::size_t idx) {
+    verdicts[pending[idx]]->matches = plugin_impl::exports_all(paths[pending[idx]].c_str(), required);
+  });
+
+  auto entries = std::vector<std::pair<std::string, plugin_impl::Verdict> >{};
+  for (std::size_t idx = 0; idx < paths.size(); ++idx) {
+    if (verdicts[idx]) {
+      matches[idx] = verdicts[idx]->matches ? 1 : 0;
+      entries.emplace_back(paths[idx].filename().string(), *verdicts[idx]);
+    }
+  }
+  if (!manifest.empty() && (!pending.empty() || entries.size() != known.size())) {
+    plugin_impl::write_manifest(manifest, signature, entries);
+  }
+#else
+  _impl::parallel_for(paths.size(), [&](std::size_t idx) { _impl::prefetch_file(paths[idx].string().c_str()); });
+#endif
+
+  auto selected = std::vector<std::size_t>{};
+  for (std::size_t idx = 0; idx < paths.size(); ++idx) {
+    if (matches[idx] != 0) {
+      selected.push_back(idx);
+    } else {
+      ++result.rejected;
+    }
+  }
+
+  // the loader serializes the dlopen calls themselves, symbol resolution runs in parallel
+  auto loaded = std::vector<std::optional<library_type> >(selected.size());
+  auto errors = std::vector<std::string>(selected.size());
+  _impl::parallel_for(selected.size(), [&](std::size_t idx) {
+    try {
+      loaded[idx].emplace(paths[selected[idx]].string());
+    } catch (std::exception const& exc) {
+      errors[idx] = exc.what();
+    }
+  });
+
+  for (std::size_t idx = 0; idx < selected.size(); ++idx) {
+    if (loaded[idx]) {
+      result.plugins.push_back({std::move(paths[selected[idx]]), std::move(*loaded[idx])});
+    } else {
+      result.failures.push_back({std::move(paths[selected[idx]]), std::move(errors[idx])});
+    }
+  }
+  return result;
+}
+}  // namespace erl
@@ -0,0 +1,321 @@
+/*
+MIT License
+
+Copyright (c) 2025 Tsche
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+
+#include <autoload.hpp>
+
+#if defined(__linux__)
+#  include <cerrno>
+#  include <cstring>
+#  include <fcntl.h>
+#  include <poll.h>
+#  include <sys/inotify.h>
+#  include <unistd.h>
+#endif
+
+namespace erl {
+/// Quiescent-state based reclamation of retired symbol tables.
+/// Threads calling through a `ReloadableLibrary` register as readers for as long as they might hold on to symbols
+/// and periodically announce that they do not, ie. between requests. Reading itself never writes shared state.
+namespace reclamation {
+namespace _impl {
+struct ReaderRecord {
+  // last epoch this reader announced, 0 while the record is unused
+  std::atomic<std::uint64_t> seen{0};
+  std::atomic<bool> in_use{false};
+  ReaderRecord* next = nullptr;
+};
+
+inline std::atomic<std::uint64_t> epoch{1};
+inline std::atomic<ReaderRecord*> readers{nullptr};
+inline thread_local ReaderRecord* current = nullptr;
+
+// records are never freed, threads exiting hand theirs to the next reader instead
+inline ReaderRecord& acquire_record() {
+  for (auto* record = readers.load(std::memory_order_acquire); record != nullptr; record = record->next) {
+    bool expected = false;
+    if (record->in_use.compare_exchange_strong(expected, true)) {
+      return *record;
+    }
+  }
+
+  auto* record = new ReaderRecord{};
+  record->in_use.store(true, std::memory_order_relaxed);
+  record->next = readers.load(std::memory_order_relaxed);
+  while (!readers.compare_exchange_weak(record->next, record, std::memory_order_release)) {
+  }
+  return *record;
+}
+}  // namespace _impl
+
+/// Registers the calling thread as a reader for the lifetime of this object.
+class Reader {
+  _impl::ReaderRecord* record;
+
+public:
+  Reader() : record(&_impl::acquire_record()) {
+    record->seen.store(_impl::epoch.load());
+    _impl::current = record;
+  }
+
+  ~Reader() {
+    _impl::current = nullptr;
+    record->seen.store(0);
+    record->in_use.store(false, std::memory_order_release);
+  }
+
+  Reader(Reader const&)            = delete;
+  Reader& operator=(Reader const&) = delete;
+};
+
+/// Announces that the calling thread holds no pointers obtained from any reloadable library.
+inline void quiescent() noexcept {
+  if (auto* record = _impl::current) {
+    record->seen.store(_impl::epoch.load());
+  }
+}
+
+/// Starts a new epoch and returns it. Anything retired now may be freed once every reader has seen it.
+inline std::uint64_t advance() noexcept {
+  return _impl::epoch.fetch_add(1) + 1;
+}
+
+/// Oldest epoch announced by any registered reader.
+inline std::uint64_t oldest() noexcept {
+  auto result = std::numeric_limits<std::uint64_t>::max();
+  for (auto* record = _impl::readers.load(std::memory_order_acquire); record != nullptr; record = record->next) {
+    if (auto seen = record->seen.load(); seen != 0) {
+      result = std::min(result, seen);
+    }
+  }
+  return result;
+}
+}  // namespace reclamation
+
+/// A library that can be swapped out for a newer build of the same file while other threads call into it.
+/// Calls cost one extra load compared to `Library`. Replaced tables and handles stay alive until every registered
+/// `reclamation::Reader` has passed a quiescent state.
+/// Updates must replace the file (ie. write elsewhere and rename over it), in-place modification of a mapped
+/// library is not supported by the loader.
+template <typename Wrapper>
+class ReloadableLibrary {
+  struct Generation {
+    int fd;
+    Library<Wrapper> library;
+    std::uint64_t retired = 0;
+    Generation* next      = nullptr;
+
+    ~Generation() {
+#if defined(__linux__)
+      if (fd >= 0) {
+        ::close(fd);
+      }
+#endif
+    }
+  };
+
+  std::string path;
+  std::atomic<Generation*> current{nullptr};
+  std::atomic<std::uint64_t> generations{0};
+
+  std::mutex writer;
+  Generation* retired = nullptr;
+  std::jthread watcher;
+
+  Generation* open() const {
+#if defined(__linux__)
+    // the loader deduplicates by name, so every generation is loaded through its own descriptor instead
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+      throw LibraryError(path + ": " + std::strerror(errno));
+    }
+
+    try {
+      auto name = "/proc/self/fd/" + std::to_string(fd);
+      return new Generation{fd, Library<Wrapper>(name.c_str())};
+    } catch (...) {
+      ::close(fd);
+      throw;
+    }
+#else
+    return new Generation{-1, Library<Wrapper>(path.c_str())};
+#endif
+  }
+
+  // requires writer to be locked
+  std::size_t collect_locked() {
+    auto oldest       = reclamation::oldest();
+    std::size_t freed = 0;
+    for (auto** link = &retired; *link != nullptr;) {
+      auto* generation = *link;
+      if (generation->retired <= oldest) {
+        *link = generation->next;
+        delete generation;
+        ++freed;
+      } else {
+        link = &generation->next;
+      }
+    }
+    return freed;
+  }
+
+#if defined(__linux__)
+  void watch_file(std::stop_token const& token,
+                  int inotify,
+                  std::string const& file,
+                  std::function<void(std::exception_ptr)> const& on_error) {
+    alignas(inotify_event) char buffer[4096];
+    while (!token.stop_requested()) {
+      pollfd request{inotify, POLLIN, 0};
+      if (::poll(&request, 1, 100) <= 0) {
+        continue;
+      }
+
+      bool changed = false;
+      for (auto size = ::read(inotify, buffer, sizeof(buffer)); size > 0;
+           size      = ::read(inotify, buffer, sizeof(buffer))) {
+        for (auto offset = 0L; offset < size;) {
+          auto const* event = reinterpret_cast<inotify_event const*>(buffer + offset);
+          changed |= event->len != 0 && file == event->name;
+          offset += static_cast<long>(sizeof(inotify_event) + event->len);
+        }
+      }
+
+      if (changed) {
+        try {
+          reload();
+        } catch (...) {
+          if (on_error) {
+            on_error(std::current_exception());
+          }
+        }
+      }
+    }
+    ::close(inotify);
+  }
+#endif
+
+public:
+  explicit ReloadableLibrary(std::string path_) : path(std::move(path_)) {
+    current.store(open(), std::memory_order_release);
+    generations.store(1, std::memory_order_relaxed);
+  }
+
+  ~ReloadableLibrary() {
+    unwatch();
+    delete current.load(std::memory_order_acquire);
+    while (retired != nullptr) {
+      delete std::exchange(retired, retired->next);
+    }
+  }
+
+  ReloadableLibrary(ReloadableLibrary const&)            = delete;
+  ReloadableLibrary& operator=(ReloadableLibrary const&) = delete;
+
+  /// Loads the file again and publishes its symbols with a single pointer swap.
+  /// If loading fails the current symbols stay active and the error is rethrown.
+  void reload() {
+    auto* fresh = open();
+    auto lock   = std::lock_guard(writer);
+
+    auto* previous    = current.exchange(fresh, std::memory_order_acq_rel);
+    previous->retired = reclamation::advance();
+    previous->next    = std::exchange(retired, previous);
+    generations.fetch_add(1, std::memory_order_relaxed);
+
+    collect_locked();
+  }
+
+  /// Frees every replaced generation no reader can still use and returns how many were freed.
+  std::size_t collect() {
+    auto lock = std::lock_guard(writer);
+    return collect_locked();
+  }
+
+  /// Blocks until every replaced generation has been freed.
+  /// Must not be called from a registered reader that has not announced a quiescent state.
+  void synchronize() {
+    while (true) {
+      {
+        auto lock = std::lock_guard(writer);
+        collect_locked();
+        if (retired == nullptr) {
+          return;
+        }
+      }
+      std::this_thread::yield();
+    }
+  }
+
+#if defined(__linux__)
+  /// Reloads automatically whenever the file is replaced. Errors during background reloads are passed to `on_error`.
+  void watch(std::function<void(std::exception_ptr)> on_error = {}) {
+    unwatch();
+
+    auto separator = path.rfind('/');
+    auto directory = separator == std::string::npos ? std::string{"."} : path.substr(0, separator + 1);
+    auto file      = separator == std::string::npos ? path : path.substr(separator + 1);
+
+    // the watch is set up before returning so no replacement after this call is missed
+    int inotify = ::inotify_init1(IN_CLOEXEC | IN_NONBLOCK);
+    if (inotify < 0 || ::inotify_add_watch(inotify, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+      auto error = LibraryError(directory + ": " + std::strerror(errno));
+      if (inotify >= 0) {
+        ::close(inotify);
+      }
+      throw error;
+    }
+
+    watcher = std::jthread(
+        [this, inotify, file = std::move(file), on_error = std::move(on_error)](std::stop_token const& token) {
+          watch_file(token, inotify, file, on_error);
+        });
+  }
+#endif
+
+  void unwatch() {
+    if (watcher.joinable()) {
+      watcher.request_stop();
+      watcher.join();
+    }
+  }
+
+  /// Number of generations published so far, starting at 1.
+  [[nodiscard]] std::uint64_t generation() const noexcept { return generations.load(std::memory_order_relaxed); }
+
+  Wrapper const& operator*() const noexcept { return *current.load(std::memory_order_acquire)->library; }
+  Wrapper const* operator->() const noexcept { return current.load(std::memory_order_acquire)->library.operator->(); }
+};
+}  // namespace erl
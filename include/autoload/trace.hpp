@@ -0,0 +1,195 @@
+/*
+MIT License
+
+Copyright (c) 2025 Tsche
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <locale>
+#include <mutex>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <autoload.hpp>
+
+#if !(defined(_WIN32) || defined(_WIN64))
+#  include <unistd.h>
+#endif
+
+namespace erl {
+/// Collects every library load and writes them as Chrome trace events (chrome://tracing, Perfetto).
+/// Each load becomes one slice with nested `open`, `resolve` and per-symbol slices on the loading thread.
+class TraceExporter : public LoadObserver {
+  struct Event {
+    LoadStats stats;
+    std::size_t thread;
+  };
+
+  mutable std::mutex mutex;
+  std::vector<Event> events;
+
+  static void write_string(std::ostream& out, std::string_view str) {
+    out << '"';
+    for (char chr : str) {
+      switch (chr) {
+        case '"': out << "\\\""; break;
+        case '\\': out << "\\\\"; break;
+        case '\n': out << "\\n"; break;
+        case '\t': out << "\\t"; break;
+        default:
+          if (static_cast<unsigned char>(chr) < 0x20) {
+            out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(chr) << std::dec;
+          } else {
+            out << chr;
+          }
+      }
+    }
+    out << '"';
+  }
+
+  static double microseconds(LoadStats::clock::duration duration) {
+    return std::chrono::duration<double, std::micro>(duration).count();
+  }
+
+  static void write_slice(std::ostream& out,
+                          std::string_view name,
+                          std::string_view category,
+                          LoadStats::clock::time_point start,
+                          LoadStats::clock::duration duration,
+                          std::size_t thread) {
+    out << "{\"name\":";
+    write_string(out, name);
+    out << ",\"cat\":";
+    write_string(out, category);
+    out << ",\"ph\":\"X\",\"ts\":" << microseconds(start.time_since_epoch()) << ",\"dur\":" << microseconds(duration)
+        << ",\"pid\":" << process_id() << ",\"tid\":" << thread << '}';
+  }
+
+  static long process_id() {
+#if !(defined(_WIN32) || defined(_WIN64))
+    return static_cast<long>(::getpid());
+#else
+    return 0;
+#endif
+  }
+
+  // small sequential ids, hashed thread ids exceed the integers JSON readers represent exactly
+  static std::size_t thread_number() noexcept {
+    static std::atomic<std::size_t> next{1};
+    thread_local std::size_t const number = next.fetch_add(1, std::memory_order_relaxed);
+    return number;
+  }
+
+public:
+  void on_load(LoadStats const& stats) override {
+    auto thread = thread_number();
+    auto lock   = std::lock_guard(mutex);
+    events.push_back({stats, thread});
+  }
+
+  [[nodiscard]] std::size_t size() const {
+    auto lock = std::lock_guard(mutex);
+    return events.size();
+  }
+
+  void clear() {
+    auto lock = std::lock_guard(mutex);
+    events.clear();
+  }
+
+  /// Writes a complete trace-event JSON document. The caller's stream formatting is left untouched.
+  void write(std::ostream& out) const { out << json(); }
+
+  [[nodiscard]] std::string json() const {
+    // formatted on a stream of its own, so neither the caller's flags, fill and precision nor its locale apply
+    auto out = std::ostringstream{};
+    out.imbue(std::locale::classic());
+    out << std::fixed << std::setprecision(3);
+
+    auto lock = std::lock_guard(mutex);
+    out << "{\"traceEvents\":[";
+
+    bool first    = true;
+    auto separate = [&] {
+      if (!first) {
+        out << ",\n";
+      }
+      first = false;
+    };
+
+    for (auto const& [stats, thread] : events) {
+      auto total = stats.total();
+      separate();
+      out << "{\"name\":";
+      write_string(out, stats.path);
+      out << ",\"cat\":\"autoload\",\"ph\":\"X\",\"ts\":" << microseconds(stats.start.time_since_epoch())
+          << ",\"dur\":" << microseconds(total) << ",\"pid\":" << process_id() << ",\"tid\":" << thread
+          << ",\"args\":{\"symbols\":" << stats.symbol_count;
+      if (stats.prefaulted_bytes != 0) {
+        out << ",\"prefaulted_bytes\":" << stats.prefaulted_bytes << ",\"locked_bytes\":" << stats.locked_bytes;
+      }
+      if (stats.failure) {
+        out << ",\"failed_index\":" << stats.failure->index << ",\"failed_symbol\":";
+        write_string(out, stats.failure->name);
+      }
+      if (!stats.error.empty()) {
+        out << ",\"error\":";
+        write_string(out, stats.error);
+      }
+      out << "}}";
+
+      if (stats.open_time.count() != 0) {
+        separate();
+        write_slice(out, "open", "autoload", stats.start, stats.open_time, thread);
+      }
+      auto offset = stats.start + stats.open_time;
+      if (stats.huge_text_time.count() != 0) {
+        separate();
+        write_slice(out, "huge_text", "autoload", offset, stats.huge_text_time, thread);
+        offset += stats.huge_text_time;
+      }
+      if (stats.prefault_time.count() != 0) {
+        separate();
+        write_slice(out, "prefault", "autoload", offset, stats.prefault_time, thread);
+        offset += stats.prefault_time;
+      }
+      if (stats.resolve_time.count() != 0) {
+        separate();
+        write_slice(out, "resolve", "autoload", offset, stats.resolve_time, thread);
+      }
+      for (auto const& symbol : stats.symbols) {
+        separate();
+        write_slice(out, symbol.name, "autoload.symbol", symbol.start, symbol.duration, thread);
+      }
+    }
+
+    out << "],\"displayTimeUnit\":\"ns\"}\n";
+    return std::move(out).str();
+  }
+};
+}  // namespace erl
@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include <autoload.hpp>
+
+namespace {
+std::atomic<std::size_t> allocations{0};
+
+#define FN(N) int (*fn_##N)();
+#define FN8(N) FN(N##0) FN(N##1) FN(N##2) FN(N##3) FN(N##4) FN(N##5) FN(N##6) FN(N##7)
+
+struct Wide {
+  FN8(0) FN8(1) FN8(2) FN8(3) FN8(4) FN8(5) FN8(6) FN8(7)
+};
+
+#undef FN8
+#undef FN
+}  // namespace
+
+void* operator new(std::size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* ptr = std::malloc(size != 0 ? size : 1)) {
+    return ptr;
+  }
+  throw std::bad_alloc{};
+}
+
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+  std::free(ptr);
+}
+
+TEST(Allocation, LoadingDoesNotAllocate) {
+  static_assert(erl::reflection::arity<Wide> == 64);
+
+  auto before = allocations.load();
+  {
+    auto lib = erl::Library<Wide>(ERL_TEST_LIBRARY);
+    EXPECT_EQ(lib->fn_00(), 0);
+    EXPECT_EQ(lib->fn_77(), 77);
+  }
+  EXPECT_EQ(allocations.load() - before, 0U);
+}
+
+TEST(Allocation, StringViewPathDoesNotAllocate) {
+  auto path   = std::string_view{ERL_TEST_LIBRARY};
+  auto before = allocations.load();
+  {
+    auto lib = erl::Library<Wide>(path);
+  }
+  EXPECT_EQ(allocations.load() - before, 0U);
+}
@@ -0,0 +1,197 @@
+#include <gtest/gtest.h>
+
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <optional>
+#include <stop_token>
+#include <type_traits>
+
+#include <autoload/async.hpp>
+
+namespace {
+struct Math {
+  int (*add)(int, int);
+  int (*mul)(int, int);
+};
+
+// runs jobs only when asked to, so tests control when loading happens
+struct ManualExecutor {
+  std::deque<std::move_only_function<void()> > jobs;
+
+  void operator()(std::move_only_function<void()> job) { jobs.push_back(std::move(job)); }
+
+  void run_all() {
+    while (!jobs.empty()) {
+      auto job = std::move(jobs.front());
+      jobs.pop_front();
+      job();
+    }
+  }
+};
+
+// cancels `task` from inside the load, after the library was opened and resolved
+struct CancelOnLoad : erl::LoadObserver {
+  erl::LoadTask<Math>* task = nullptr;
+
+  void on_load(erl::LoadStats const&) override { task->cancel(); }
+};
+
+// starts eagerly and never suspends at the end, enough to drive a single co_await
+struct Detached {
+  struct promise_type {
+    Detached get_return_object() { return {}; }
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() {}
+    void unhandled_exception() { std::terminate(); }
+  };
+};
+
+struct Outcome {
+  std::optional<int> value;
+  std::exception_ptr error;
+};
+
+Detached add_async(erl::LoadTask<Math>& task, Outcome& outcome) {
+  try {
+    auto lib      = co_await task;
+    outcome.value = lib->add(20, 22);
+  } catch (...) {
+    outcome.error = std::current_exception();
+  }
+}
+
+Detached add_async_on(erl::LoadTask<Math>& task, ManualExecutor& resumer, Outcome& outcome) {
+  try {
+    auto lib      = co_await task.resume_on(resumer);
+    outcome.value = lib->add(20, 22);
+  } catch (...) {
+    outcome.error = std::current_exception();
+  }
+}
+}  // namespace
+
+static_assert(!std::is_copy_constructible_v<erl::LoadTask<Math> >);
+static_assert(!std::is_copy_assignable_v<erl::LoadTask<Math> >);
+static_assert(std::is_nothrow_move_constructible_v<erl::LoadTask<Math> >);
+
+TEST(Async, GetReturnsLoadedLibrary) {
+  auto task = erl::load_async<Math>(ERL_TEST_LIBRARY);
+  ASSERT_TRUE(task.valid());
+
+  auto lib = task.get();
+  EXPECT_FALSE(task.valid());
+  EXPECT_EQ(lib->add(1, 2), 3);
+  EXPECT_EQ(lib->mul(2, 3), 6);
+}
+
+TEST(Async, GetRethrowsLoadErrors) {
+  auto task = erl::load_async<Math>("does_not_exist.so");
+  EXPECT_THROW(task.get(), erl::LibraryError);
+}
+
+TEST(Async, AwaitResumesWhenLoaded) {
+  auto executor = ManualExecutor{};
+  auto outcome  = Outcome{};
+
+  auto task = erl::load_async<Math>(ERL_TEST_LIBRARY, executor);
+  add_async(task, outcome);
+  EXPECT_FALSE(outcome.value.has_value());
+
+  executor.run_all();
+  ASSERT_TRUE(outcome.value.has_value());
+  EXPECT_EQ(*outcome.value, 42);
+}
+
+TEST(Async, AwaitPropagatesErrors) {
+  auto executor = ManualExecutor{};
+  auto outcome  = Outcome{};
+
+  auto task = erl::load_async<Math>("does_not_exist.so", executor);
+  add_async(task, outcome);
+  executor.run_all();
+  ASSERT_TRUE(outcome.error);
+  EXPECT_THROW(std::rethrow_exception(outcome.error), erl::LibraryError);
+}
+
+TEST(Async, CancelBeforeStart) {
+  auto executor = ManualExecutor{};
+  auto task     = erl::load_async<Math>(ERL_TEST_LIBRARY, executor);
+
+  task.cancel();
+  EXPECT_TRUE(task.ready());
+  executor.run_all();
+  EXPECT_THROW(task.get(), erl::LoadCancelled);
+}
+
+TEST(Async, CancelResumesAwaiter) {
+  auto executor = ManualExecutor{};
+  auto outcome  = Outcome{};
+
+  auto task = erl::load_async<Math>(ERL_TEST_LIBRARY, executor);
+  add_async(task, outcome);
+  task.cancel();
+  ASSERT_TRUE(outcome.error);
+  EXPECT_THROW(std::rethrow_exception(outcome.error), erl::LoadCancelled);
+  EXPECT_FALSE(outcome.value.has_value());
+
+  executor.run_all();
+}
+
+TEST(Async, CancelWhileLoading) {
+  auto executor = ManualExecutor{};
+  auto observer = CancelOnLoad{};
+  auto task     = erl::load_async<Math>(ERL_TEST_LIBRARY, executor);
+  observer.task = &task;
+
+  auto* previous = erl::set_load_observer(&observer);
+  executor.run_all();
+  erl::set_load_observer(previous);
+
+  EXPECT_THROW(task.get(), erl::LoadCancelled);
+}
+
+TEST(Async, CancelAfterLoadHasNoEffect) {
+  auto task = erl::load_async<Math>(ERL_TEST_LIBRARY);
+  task.wait();
+  task.cancel();
+  EXPECT_EQ(task.get()->add(2, 2), 4);
+}
+
+TEST(Async, ResumeOnExecutor) {
+  auto loader  = ManualExecutor{};
+  auto resumer = ManualExecutor{};
+  auto outcome = Outcome{};
+
+  auto task = erl::load_async<Math>(ERL_TEST_LIBRARY, loader);
+  add_async_on(task, resumer, outcome);
+  loader.run_all();
+  EXPECT_FALSE(outcome.value.has_value());
+  ASSERT_EQ(resumer.jobs.size(), 1U);
+
+  resumer.run_all();
+  ASSERT_TRUE(outcome.value.has_value());
+  EXPECT_EQ(*outcome.value, 42);
+}
+
+TEST(Async, StopTokenCancels) {
+  auto executor = ManualExecutor{};
+  auto source   = std::stop_source{};
+  auto task     = erl::load_async<Math>(ERL_TEST_LIBRARY, executor, source.get_token());
+
+  EXPECT_FALSE(task.ready());
+  source.request_stop();
+  EXPECT_TRUE(task.ready());
+  executor.run_all();
+  EXPECT_THROW(task.get(), erl::LoadCancelled);
+}
+
+TEST(Async, StopAfterLoadHasNoEffect) {
+  auto source = std::stop_source{};
+  auto task   = erl::load_async<Math>(ERL_TEST_LIBRARY, source.get_token());
+  task.wait();
+  source.request_stop();
+  EXPECT_EQ(task.get()->add(2, 2), 4);
+}
@@ -0,0 +1,192 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+#include <autoload.hpp>
+
+namespace {
+namespace fs = std::filesystem;
+
+struct Math {
+  int (*add)(int, int);
+  int (*mul)(int, int);
+  int* counter;
+};
+
+struct Adder {
+  int (*add)(int, int);
+};
+
+struct Partial {
+  int (*add)(int, int);
+  erl::Optional<void (*)()> does_not_exist;
+};
+
+class Cache : public testing::Test {
+protected:
+  fs::path directory;
+
+  void SetUp() override {
+    directory = fs::temp_directory_path() / ("autoload_cache_" + std::to_string(::getpid()));
+    fs::create_directories(directory);
+    erl::set_symbol_cache_directory(directory.string());
+  }
+
+  void TearDown() override {
+    erl::set_symbol_cache_directory("");
+    erl::set_cpu_level(std::nullopt);
+    fs::remove_all(directory);
+  }
+
+  [[nodiscard]] std::vector<fs::path> files() const {
+    std::vector<fs::path> result;
+    for (auto const& entry : fs::directory_iterator(directory)) {
+      result.push_back(entry.path());
+    }
+    return result;
+  }
+};
+}  // namespace
+
+TEST_F(Cache, WarmStartSkipsLookups) {
+  auto stats = erl::LoadStats{};
+  auto cold  = erl::Library<Math, erl::cached>(ERL_TEST_LIBRARY, stats);
+  EXPECT_FALSE(stats.cached);
+  ASSERT_EQ(files().size(), 1U);
+
+  auto warm_stats = erl::LoadStats{};
+  auto warm       = erl::Library<Math, erl::cached>(ERL_TEST_LIBRARY, warm_stats);
+  EXPECT_TRUE(warm_stats.cached);
+  EXPECT_TRUE(warm_stats.symbols.empty());
+  EXPECT_EQ(warm->add, cold->add);
+  EXPECT_EQ(warm->counter, cold->counter);
+  EXPECT_EQ(warm->mul(6, 7), 42);
+}
+
+TEST_F(Cache, NextProcessReadsFile) {
+  { auto cold = erl::Library<Math, erl::cached>(ERL_TEST_LIBRARY); }
+  erl::set_symbol_cache_directory(directory.string());
+
+  auto stats = erl::LoadStats{};
+  auto warm  = erl::Library<Math, erl::cached>(ERL_TEST_LIBRARY, stats);
+  EXPECT_TRUE(stats.cached);
+  EXPECT_EQ(warm->mul(6, 7), 42);
+
+  // remembered from here on, even without the file
+  fs::remove(files()[0]);
+  auto again = erl::LoadStats{};
+  auto lib   = erl::Library<Math, erl::cached>(ERL_TEST_LIBRARY, again);
+  EXPECT_TRUE(again.cached);
+}
+
+TEST_F(Cache, IndirectFunctionsAreNotCached) {
+  struct Indirect {
+    int (*add)(int, int);
+    int (*indirect)();
+  };
+  auto lib = erl::Library<Indirect, erl::cached>(ERL_TEST_LIBRARY);
+  EXPECT_EQ(lib->indirect(), 7);
+  EXPECT_TRUE(files().empty());
+}
+
+TEST_F(Cache, LazyColdStartServesEagerInstances) {
+  auto cold = erl::Library<Math, erl::lazy, erl::cached>(ERL_TEST_LIBRARY);
+  EXPECT_EQ(cold->add(1, 2), 3);
+
+  auto stats = erl::LoadStats{};
+  auto warm  = erl::Library<Math, erl::cached>(ERL_TEST_LIBRARY, stats);
+  EXPECT_TRUE(stats.cached);
+  EXPECT_EQ(warm->mul(6, 7), 42);
+
+  auto lazy_stats = erl::LoadStats{};
+  auto lazy       = erl::Library<Math, erl::lazy, erl::cached>(ERL_TEST_LIBRARY, lazy_stats);
+  EXPECT_TRUE(lazy_stats.cached);
+  EXPECT_EQ(lazy->add(20, 22), 42);
+}
+
+TEST_F(Cache, KeyedByWrapperSignature) {
+  auto math  = erl::Library<Math, erl::cached>(ERL_TEST_LIBRARY);
+  auto adder = erl::Library<Adder, erl::cached>(ERL_TEST_LIBRARY);
+  EXPECT_EQ(files().size(), 2U);
+
+  auto stats = erl::LoadStats{};
+  auto again = erl::Library<Adder, erl::cached>(ERL_TEST_LIBRARY, stats);
+  EXPECT_TRUE(stats.cached);
+  EXPECT_EQ(again->add(2, 3), 5);
+}
+
+TEST_F(Cache, MissingOptionalSymbolsAreCached) {
+  { auto cold = erl::Library<Partial, erl::cached>(ERL_TEST_LIBRARY); }
+
+  auto stats = erl::LoadStats{};
+  auto warm  = erl::Library<Partial, erl::cached>(ERL_TEST_LIBRARY, stats);
+  EXPECT_TRUE(stats.cached);
+  EXPECT_FALSE(warm->does_not_exist);
+  EXPECT_EQ(warm->add(1, 1), 2);
+}
+
+TEST_F(Cache, CorruptFileIsReplaced) {
+  { auto cold = erl::Library<Math, erl::cached>(ERL_TEST_LIBRARY); }
+  ASSERT_EQ(files().size(), 1U);
+  {
+    auto file = std::fstream(files()[0], std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(-1, std::ios::end);
+    file.put('\x7f');
+  }
+
+  // this process remembers the offsets, a fresh directory setting stands in for the next process
+  erl::set_symbol_cache_directory(directory.string());
+  auto stats = erl::LoadStats{};
+  auto lib   = erl::Library<Math, erl::cached>(ERL_TEST_LIBRARY, stats);
+  EXPECT_FALSE(stats.cached);
+  EXPECT_EQ(lib->add(2, 2), 4);
+
+  auto warm_stats = erl::LoadStats{};
+  auto warm       = erl::Library<Math, erl::cached>(ERL_TEST_LIBRARY, warm_stats);
+  EXPECT_TRUE(warm_stats.cached);
+}
+
+TEST_F(Cache, DisabledWithoutDirectory) {
+  erl::set_symbol_cache_directory("");
+  auto stats = erl::LoadStats{};
+  auto lib   = erl::Library<Math, erl::cached>(ERL_TEST_LIBRARY, stats);
+  EXPECT_FALSE(stats.cached);
+  EXPECT_TRUE(files().empty());
+}
+
+TEST_F(Cache, ConcurrentWriters) {
+  {
+    std::vector<std::jthread> threads;
+    for (int idx = 0; idx < 16; ++idx) {
+      threads.emplace_back([] {
+        for (int iteration = 0; iteration < 20; ++iteration) {
+          auto lib = erl::Library<Math, erl::cached>(ERL_TEST_LIBRARY);
+          EXPECT_EQ(lib->add(1, 2), 3);
+        }
+      });
+    }
+  }
+
+  // temporary files are renamed into place or removed
+  EXPECT_EQ(files().size(), 1U);
+  auto stats = erl::LoadStats{};
+  auto lib   = erl::Library<Math, erl::cached>(ERL_TEST_LIBRARY, stats);
+  EXPECT_TRUE(stats.cached);
+}
+
+TEST_F(Cache, KeyedByCpuLevel) {
+  struct Kernels {
+    int (*dot)();
+  };
+  using Dispatched = erl::Library<Kernels, erl::cached, erl::variants>;
+
+  erl::set_cpu_level(erl::CpuLevel::avx2);
+  EXPECT_EQ(Dispatched(ERL_TEST_LIBRARY)->dot(), 2);
+  EXPECT_EQ(Dispatched(ERL_TEST_LIBRARY)->dot(), 2);
+
+  erl::set_cpu_level(erl::CpuLevel::sse42);
+  EXPECT_EQ(Dispatched(ERL_TEST_LIBRARY)->dot(), 1);
+}
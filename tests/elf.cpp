@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+
+#include <autoload.hpp>
+
+#if ERL_HAS_ELF_LOOKUP
+namespace {
+struct Handle {
+  erl::platform::handle_type value = erl::platform::load_library(ERL_TEST_LIBRARY);
+  ~Handle() { erl::platform::unload_library(value); }
+};
+}  // namespace
+
+TEST(Elf, KnownHashes) {
+  static_assert(erl::platform::elf::gnu_hash("") == 5381);
+  static_assert(erl::platform::elf::gnu_hash("printf") == 0x156b2bb8);
+  static_assert(erl::platform::elf::sysv_hash("printf") == 0x077905a6);
+}
+
+TEST(Elf, MatchesDlsym) {
+  Handle handle;
+  auto table = erl::platform::elf::SymbolTable(handle.value);
+  ASSERT_TRUE(table.valid());
+
+  for (auto name : {"add", "mul", "sum", "counter"}) {
+    EXPECT_EQ(table.find(name), ::dlsym(handle.value, name)) << name;
+  }
+}
+
+TEST(Elf, MissingSymbol) {
+  Handle handle;
+  auto table = erl::platform::elf::SymbolTable(handle.value);
+  EXPECT_EQ(table.find("does_not_exist"), nullptr);
+  EXPECT_EQ(table.find("ad"), nullptr);
+  EXPECT_EQ(table.find("addd"), nullptr);
+}
+
+TEST(Elf, ResolverFallsBackToDependencies) {
+  Handle handle;
+  auto table    = erl::platform::elf::SymbolTable(handle.value);
+  auto resolver = erl::platform::SymbolResolver(handle.value);
+
+  // malloc lives in libc, which only dlsym searches
+  EXPECT_EQ(table.find("malloc"), nullptr);
+  EXPECT_EQ(resolver("malloc"), ::dlsym(handle.value, "malloc"));
+  EXPECT_THROW(resolver("does_not_exist"), erl::LibraryError);
+}
+#endif
+
+namespace {
+struct Hashed {
+  int (*add)(int, int);
+  int* counter;
+};
+
+// forces constant evaluation, this does not compile if any hash needs runtime work
+template <std::uint32_t Hash>
+inline constexpr std::uint32_t constant = Hash;
+}  // namespace
+
+TEST(Elf, MemberHashesAreCompileTime) {
+  constexpr auto const& hashes = erl::reflection::member_hashes<Hashed>;
+  static_assert(hashes.size() == 2);
+
+  static_assert(constant<hashes[0].gnu> == erl::platform::elf::gnu_hash("add"));
+  static_assert(constant<hashes[0].sysv> == erl::platform::elf::sysv_hash("add"));
+  static_assert(hashes[0].length == 3);
+
+  static_assert(constant<hashes[1].gnu> == erl::platform::elf::gnu_hash("counter"));
+  static_assert(constant<hashes[1].sysv> == erl::platform::elf::sysv_hash("counter"));
+  static_assert(hashes[1].length == 7);
+}
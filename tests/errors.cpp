@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <autoload.hpp>
+
+namespace {
+struct Math {
+  int (*add)(int, int);
+};
+
+bool contains(std::string_view haystack, std::string_view needle) {
+  return haystack.find(needle) != std::string_view::npos;
+}
+}  // namespace
+
+TEST(Errors, StaleLookupErrorsAreNotReported) {
+  auto handle = erl::platform::load_library(ERL_TEST_LIBRARY);
+  EXPECT_EQ(erl::platform::find_symbol(handle, "does_not_exist"), nullptr);
+  EXPECT_TRUE(erl::platform::get_last_error().empty());
+
+  try {
+    erl::platform::load_library("/does/not/exist.so");
+    FAIL() << "expected LibraryError";
+  } catch (erl::LibraryError const& error) {
+    EXPECT_TRUE(contains(error.what(), "/does/not/exist.so")) << error.what();
+    EXPECT_FALSE(contains(error.what(), "does_not_exist")) << error.what();
+  }
+  erl::platform::unload_library(handle);
+}
+
+TEST(Errors, ConcurrentLoadAndUnload) {
+  constexpr int thread_count = 32;
+  constexpr int iterations   = 50;
+
+  std::atomic<int> mismatches{0};
+  std::vector<std::jthread> threads;
+  for (int thread = 0; thread < thread_count; ++thread) {
+    threads.emplace_back([&, thread] {
+      for (int iteration = 0; iteration < iterations; ++iteration) {
+        auto suffix = std::to_string(thread) + "_" + std::to_string(iteration);
+
+        auto lib = erl::Library<Math>(ERL_TEST_LIBRARY);
+        if (lib->add(thread, iteration) != thread + iteration) {
+          ++mismatches;
+        }
+
+        auto path = "/does/not/exist_" + suffix + ".so";
+        try {
+          erl::platform::load_library(path);
+          ++mismatches;
+        } catch (erl::LibraryError const& error) {
+          mismatches += contains(error.what(), path) ? 0 : 1;
+        }
+
+        auto symbol = "missing_" + suffix;
+        auto handle = erl::platform::load_library(ERL_TEST_LIBRARY);
+        try {
+          erl::platform::get_symbol(handle, symbol);
+          ++mismatches;
+        } catch (erl::LibraryError const& error) {
+          mismatches += contains(error.what(), symbol) ? 0 : 1;
+        }
+        erl::platform::unload_library(handle);
+      }
+    });
+  }
+  threads.clear();
+
+  EXPECT_EQ(mismatches.load(), 0);
+}
@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+
+#include <set>
+#include <string_view>
+
+#include <autoload.hpp>
+
+namespace {
+struct Arithmetic {
+  int (*add)(int, int);
+  erl::Optional<int (*)(int, int)> mul;
+};
+
+struct Numbers {
+  int (*fn_00)();
+  struct {
+    int (*fn_01)();
+    int (*fn_02)();
+  } inner;
+};
+
+struct Api {
+  int* counter;
+  Arithmetic arithmetic;
+  struct {
+  } empty;
+  Numbers numbers;
+  int (*version)();
+};
+
+struct BrokenApi {
+  Arithmetic arithmetic;
+  struct {
+    int (*first_missing)();
+  } missing;
+  int (*second_missing)();
+};
+
+// mirrors the exports of lib/scalelib.c, 40 groups of 50 members
+#define ERL_SCALE_FN(N) int (*fn_##N)(int);
+#define ERL_SCALE_FN10(N)                                                                                  \
+  ERL_SCALE_FN(N##0) ERL_SCALE_FN(N##1) ERL_SCALE_FN(N##2) ERL_SCALE_FN(N##3) ERL_SCALE_FN(N##4)           \
+  ERL_SCALE_FN(N##5) ERL_SCALE_FN(N##6) ERL_SCALE_FN(N##7) ERL_SCALE_FN(N##8) ERL_SCALE_FN(N##9)
+#define ERL_SCALE_GROUP(G) \
+  struct {                 \
+    ERL_SCALE_FN10(G##0)   \
+    ERL_SCALE_FN10(G##1)   \
+    ERL_SCALE_FN10(G##2)   \
+    ERL_SCALE_FN10(G##3)   \
+    ERL_SCALE_FN10(G##4)   \
+  } group_##G;
+#define ERL_SCALE_GROUP10(G)                                                                                   \
+  ERL_SCALE_GROUP(G##0) ERL_SCALE_GROUP(G##1) ERL_SCALE_GROUP(G##2) ERL_SCALE_GROUP(G##3) ERL_SCALE_GROUP(G##4) \
+  ERL_SCALE_GROUP(G##5) ERL_SCALE_GROUP(G##6) ERL_SCALE_GROUP(G##7) ERL_SCALE_GROUP(G##8) ERL_SCALE_GROUP(G##9)
+
+struct Scale {
+  ERL_SCALE_GROUP10(0)
+  ERL_SCALE_GROUP10(1)
+  ERL_SCALE_GROUP10(2)
+  ERL_SCALE_GROUP10(3)
+};
+
+#undef ERL_SCALE_GROUP10
+#undef ERL_SCALE_GROUP
+#undef ERL_SCALE_FN10
+#undef ERL_SCALE_FN
+}  // namespace
+
+TEST(Groups, FlattensNestedMembers) {
+  static_assert(erl::reflection::symbol_count<Api> == 7);
+  static_assert(erl::reflection::symbol_names<Api>[0] == "counter");
+  static_assert(erl::reflection::symbol_names<Api>[2] == "mul");
+  static_assert(erl::reflection::symbol_names<Api>[3] == "fn_00");
+  static_assert(erl::reflection::symbol_names<Api>[5] == "fn_02");
+  EXPECT_STREQ(erl::reflection::symbol_cnames<Api>[6], "version");
+}
+
+TEST(Groups, ResolvesEveryLevel) {
+  auto stats = erl::LoadStats{};
+  auto lib   = erl::Library<Api>(ERL_TEST_LIBRARY, stats);
+  EXPECT_EQ(lib->arithmetic.add(2, 3), 5);
+  ASSERT_TRUE(lib->arithmetic.mul);
+  EXPECT_EQ(lib->arithmetic.mul(6, 7), 42);
+  EXPECT_EQ(lib->numbers.fn_00(), 0);
+  EXPECT_EQ(lib->numbers.inner.fn_02(), 2);
+  EXPECT_EQ(lib->version(), 1);
+  ASSERT_NE(lib->counter, nullptr);
+
+  EXPECT_EQ(stats.symbol_count, 7U);
+  ASSERT_EQ(stats.symbols.size(), 7U);
+  EXPECT_EQ(stats.symbols[4].name, "fn_01");
+}
+
+TEST(Groups, ReportsMissingSymbolsByName) {
+  try {
+    auto lib = erl::Library<BrokenApi>(ERL_TEST_LIBRARY);
+    FAIL() << "expected MissingSymbolError";
+  } catch (erl::MissingSymbolError const& error) {
+    ASSERT_EQ(error.symbols.size(), 2U);
+    EXPECT_EQ(error.symbols[0], "first_missing");
+    EXPECT_EQ(error.symbols[1], "second_missing");
+  }
+}
+
+TEST(Groups, LazyStubsNestedMembers) {
+  auto eager = erl::Library<Api>(ERL_TEST_LIBRARY);
+  auto lib   = erl::Library<Api, erl::lazy>(ERL_TEST_LIBRARY);
+  EXPECT_NE(lib->numbers.inner.fn_01, eager->numbers.inner.fn_01);
+  EXPECT_EQ(lib->numbers.inner.fn_01(), 1);
+  EXPECT_EQ(lib->numbers.inner.fn_01, eager->numbers.inner.fn_01);
+
+  lib.resolve_all();
+  EXPECT_EQ(lib->arithmetic.add, eager->arithmetic.add);
+  EXPECT_EQ(lib->version, eager->version);
+}
+
+TEST(Groups, ScalesToThousandsOfSymbols) {
+  static_assert(erl::reflection::symbol_count<Scale> == 2000);
+
+  auto stats = erl::LoadStats{};
+  auto lib   = erl::Library<Scale>(ERL_TEST_LIBRARY_SCALE, stats);
+  EXPECT_EQ(lib->group_00.fn_0000(0), 10000);
+  EXPECT_EQ(lib->group_17.fn_1723(1), 11724);
+  EXPECT_EQ(lib->group_39.fn_3949(0), 13949);
+  ASSERT_EQ(stats.symbols.size(), 2000U);
+
+  auto names = std::set<std::string_view>{};
+  auto calls = 0;
+  erl::reflection::for_each_symbol(*lib, [&]<std::size_t Idx>(auto const& member) {
+    names.insert(erl::reflection::symbol_names<Scale>[Idx]);
+    // fn_GGMM returns its argument plus 1GGMM
+    calls += static_cast<int>(member(0) == 10000 + static_cast<int>((Idx / 50 * 100) + (Idx % 50)));
+  });
+  EXPECT_EQ(names.size(), 2000U);
+  EXPECT_EQ(calls, 2000);
+}
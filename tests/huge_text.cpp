@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <autoload.hpp>
+
+#if ERL_HAS_ELF_LOOKUP
+namespace {
+struct Padded {
+  int (*padded_answer)();
+  int (*add)(int, int);
+};
+
+bool huge_pages_enabled() {
+  auto file = std::ifstream("/sys/kernel/mm/transparent_hugepage/enabled");
+  auto mode = std::string{};
+  std::getline(file, mode);
+  return mode.find("[always]") != std::string::npos || mode.find("[madvise]") != std::string::npos;
+}
+
+// the pathname column of /proc/self/maps for the mapping containing `address`
+std::string mapping_of(void const* address) {
+  auto target = reinterpret_cast<std::uintptr_t>(address);
+  auto maps   = std::ifstream("/proc/self/maps");
+  for (std::string line; std::getline(maps, line);) {
+    auto stream = std::istringstream(line);
+    std::uintptr_t begin = 0;
+    std::uintptr_t end   = 0;
+    char dash            = 0;
+    std::string permissions, offset, device, inode, path;
+    stream >> std::hex >> begin >> dash >> end >> permissions >> offset >> device >> inode >> path;
+    if (target >= begin && target < end) {
+      return path;
+    }
+  }
+  return "<unmapped>";
+}
+}  // namespace
+
+TEST(HugeText, MovesAlignedTextOffTheFile) {
+  auto stats = erl::LoadStats{};
+  auto lib   = erl::Library<Padded, erl::huge_text>(ERL_TEST_LIBRARY_LARGE, stats);
+  EXPECT_EQ(lib->padded_answer(), 42);
+  EXPECT_EQ(lib->add(2, 3), 5);
+
+  if (!huge_pages_enabled()) {
+    EXPECT_EQ(stats.huge_text_bytes, 0U);
+    GTEST_SKIP() << "transparent huge pages are disabled";
+  }
+  EXPECT_GE(stats.huge_text_bytes, std::size_t{2} << 20U);
+  EXPECT_EQ(stats.huge_text_bytes % (std::size_t{2} << 20U), 0U);
+  EXPECT_EQ(mapping_of(reinterpret_cast<void const*>(lib->padded_answer)), "");
+}
+
+TEST(HugeText, SmallLibrariesAreLeftAlone) {
+  struct Small {
+    int (*add)(int, int);
+  };
+  auto stats = erl::LoadStats{};
+  auto small = erl::Library<Small, erl::huge_text>(ERL_TEST_LIBRARY, stats);
+  EXPECT_EQ(stats.huge_text_bytes, 0U);
+  EXPECT_GT(stats.huge_text_time.count(), 0);
+  EXPECT_EQ(stats.prefault_time, erl::LoadStats::clock::duration{});
+  EXPECT_EQ(small->add(1, 1), 2);
+}
+#endif
@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include <autoload.hpp>
+
+namespace {
+struct Interface {
+  int* counter;
+  int (*add)(int, int);
+  erl::Optional<int (*)(int, int)> mul;
+  erl::Optional<int (*)(int, int)> newer_entry_point;
+  int (*sum)(int, ...);
+};
+
+using Instrumented = erl::Library<Interface, erl::instrumented>;
+
+erl::CallStats stats_of(std::string_view name) {
+  for (auto const& entry : Instrumented::call_stats()) {
+    if (entry.name == name) {
+      return entry;
+    }
+  }
+  return {};
+}
+}  // namespace
+
+TEST(Instrumented, CountsCalls) {
+  auto lib    = Instrumented(ERL_TEST_LIBRARY);
+  auto before = stats_of("add").calls;
+  auto mul    = stats_of("mul").calls;
+
+  EXPECT_EQ(lib->add(1, 2), 3);
+  EXPECT_EQ(lib->add(3, 4), 7);
+  EXPECT_EQ(lib->mul(6, 7), 42);
+
+  auto add = stats_of("add");
+  EXPECT_EQ(add.calls, before + 2);
+  EXPECT_EQ(std::accumulate(add.histogram.begin(), add.histogram.end(), std::uint64_t{0}), add.calls);
+  EXPECT_EQ(stats_of("mul").calls, mul + 1);
+}
+
+TEST(Instrumented, LeavesOtherMembersAlone) {
+  auto eager = erl::Library<Interface>(ERL_TEST_LIBRARY);
+  auto lib   = Instrumented(ERL_TEST_LIBRARY);
+
+  EXPECT_NE(lib->add, eager->add);
+  EXPECT_EQ(lib->counter, eager->counter);
+  EXPECT_EQ(lib->sum, eager->sum);
+  EXPECT_FALSE(lib->newer_entry_point);
+  EXPECT_EQ(stats_of("sum").calls, 0U);
+}
+
+TEST(Instrumented, MergesCallsFromExitedThreads) {
+  auto lib    = Instrumented(ERL_TEST_LIBRARY);
+  auto before = stats_of("add").calls;
+
+  auto threads = std::vector<std::jthread>{};
+  for (int idx = 0; idx < 4; ++idx) {
+    threads.emplace_back([&] {
+      for (int call = 0; call < 1000; ++call) {
+        lib->add(call, 1);
+      }
+    });
+  }
+  threads.clear();
+
+  EXPECT_EQ(stats_of("add").calls, before + 4000);
+}
+
+TEST(Instrumented, SurvivesMove) {
+  auto lib    = Instrumented(ERL_TEST_LIBRARY);
+  auto moved  = std::move(lib);
+  auto before = stats_of("add").calls;
+  EXPECT_EQ(moved->add(20, 22), 42);
+  EXPECT_EQ(stats_of("add").calls, before + 1);
+}
+
+TEST(Instrumented, InstancesOfOneTypeShareCounters) {
+  auto first  = Instrumented(ERL_TEST_LIBRARY);
+  auto second = Instrumented(ERL_TEST_LIBRARY);
+  auto before = stats_of("add").calls;
+  first->add(1, 1);
+  second->add(2, 2);
+  EXPECT_EQ(stats_of("add").calls, before + 2);
+}
+
+TEST(Instrumented, ProbeOutlivingLibraryThrows) {
+  auto add = [] {
+    auto lib = Instrumented(ERL_TEST_LIBRARY);
+    return lib->add;
+  }();
+  EXPECT_THROW(add(1, 2), erl::LibraryError);
+}
+
+TEST(Instrumented, LimitsLiveInstances) {
+  struct Small {
+    int (*add)(int, int);
+  };
+  using Limited = erl::Library<Small, erl::basic_instrumented<1> >;
+
+  auto first = Limited(ERL_TEST_LIBRARY);
+  EXPECT_THROW(Limited{ERL_TEST_LIBRARY}, erl::LibraryError);
+}
@@ -0,0 +1,41 @@
+// built with ERL_INSTRUMENTATION=false, see CMakeLists.txt
+#include <gtest/gtest.h>
+
+#include <autoload.hpp>
+
+namespace {
+struct Interface {
+  int* counter;
+  int (*add)(int, int);
+};
+
+using Instrumented = erl::Library<Interface, erl::instrumented>;
+}  // namespace
+
+static_assert(!erl::instrumented::probes);
+
+TEST(InstrumentedOff, CallsStraightThrough) {
+  auto eager = erl::Library<Interface>(ERL_TEST_LIBRARY);
+  auto lib   = Instrumented(ERL_TEST_LIBRARY);
+
+  EXPECT_EQ(lib->add, eager->add);
+  EXPECT_EQ(lib->add(20, 22), 42);
+  EXPECT_EQ(lib->counter, eager->counter);
+}
+
+TEST(InstrumentedOff, StatsStayZero) {
+  auto lib = Instrumented(ERL_TEST_LIBRARY);
+  lib->add(1, 1);
+
+  auto stats = Instrumented::call_stats();
+  ASSERT_EQ(stats.size(), 2U);
+  EXPECT_EQ(stats[1].name, "add");
+  EXPECT_EQ(stats[1].calls, 0U);
+}
+
+TEST(InstrumentedOff, NoInstanceLimit) {
+  using Limited = erl::Library<Interface, erl::basic_instrumented<1> >;
+  auto first    = Limited(ERL_TEST_LIBRARY);
+  auto second   = Limited(ERL_TEST_LIBRARY);
+  EXPECT_EQ(second->add(1, 2), 3);
+}
@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include <autoload.hpp>
+
+#if ERL_HAS_DLMOPEN
+namespace {
+struct Counter {
+  int (*add)(int, int);
+  int* counter;
+};
+}  // namespace
+
+TEST(Isolated, InstancesHaveTheirOwnGlobals) {
+  auto first  = erl::Library<Counter, erl::isolated>(ERL_TEST_LIBRARY);
+  auto second = erl::Library<Counter, erl::isolated>(ERL_TEST_LIBRARY);
+  EXPECT_NE(first.native_handle(), second.native_handle());
+  ASSERT_NE(first->counter, second->counter);
+
+  first->add(1, 2);
+  first->add(3, 4);
+  second->add(5, 6);
+  EXPECT_EQ(*first->counter, 2);
+  EXPECT_EQ(*second->counter, 1);
+}
+
+TEST(Isolated, DefaultNamespaceIsUnaffected) {
+  auto shared   = erl::Library<Counter>(ERL_TEST_LIBRARY);
+  auto isolated = erl::Library<Counter, erl::isolated>(ERL_TEST_LIBRARY);
+  EXPECT_NE(shared->counter, isolated->counter);
+
+  auto before = *shared->counter;
+  isolated->add(1, 1);
+  EXPECT_EQ(*shared->counter, before);
+}
+
+TEST(Isolated, NamespacesAreReused) {
+  // more rounds than glibc has namespaces
+  for (int round = 0; round < 32; ++round) {
+    auto lib = erl::Library<Counter, erl::isolated>(ERL_TEST_LIBRARY);
+    EXPECT_EQ(lib->add(round, 1), round + 1);
+    EXPECT_EQ(*lib->counter, 1);
+  }
+}
+
+TEST(Isolated, WorkersNeedNoLocking) {
+  constexpr int worker_count = 4;
+  constexpr int iterations   = 100'000;
+
+  std::vector<erl::Library<Counter, erl::isolated> > instances;
+  for (int idx = 0; idx < worker_count; ++idx) {
+    instances.emplace_back(ERL_TEST_LIBRARY);
+  }
+
+  {
+    std::vector<std::jthread> workers;
+    for (auto& instance : instances) {
+      workers.emplace_back([&instance] {
+        for (int idx = 0; idx < iterations; ++idx) {
+          instance->add(idx, idx);
+        }
+      });
+    }
+  }
+
+  for (auto const& instance : instances) {
+    EXPECT_EQ(*instance->counter, iterations);
+  }
+}
+#endif
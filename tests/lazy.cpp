@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+
+#include <autoload.hpp>
+
+namespace {
+struct Interface {
+  int* counter;
+  int (*add)(int, int);
+  int (*mul)(int, int);
+  int (*sum)(int, ...);
+};
+
+struct Missing {
+  int (*add)(int, int);
+  int (*does_not_exist)(int, int);
+};
+}  // namespace
+
+TEST(Lazy, MembersStartOutStubbed) {
+  auto eager = erl::Library<Interface>(ERL_TEST_LIBRARY);
+  auto lib   = erl::Library<Interface, erl::lazy>(ERL_TEST_LIBRARY);
+
+  EXPECT_NE(lib->add, eager->add);
+  EXPECT_NE(lib->mul, eager->mul);
+
+  // data and variadic members cannot be stubbed
+  EXPECT_EQ(lib->counter, eager->counter);
+  EXPECT_EQ(lib->sum, eager->sum);
+}
+
+TEST(Lazy, FirstCallPatchesSlot) {
+  auto eager = erl::Library<Interface>(ERL_TEST_LIBRARY);
+  auto lib   = erl::Library<Interface, erl::lazy>(ERL_TEST_LIBRARY);
+
+  EXPECT_EQ(lib->add(2, 3), 5);
+  EXPECT_EQ(lib->add, eager->add);
+  EXPECT_NE(lib->mul, eager->mul);
+
+  EXPECT_EQ(lib->mul(2, 3), 6);
+  EXPECT_EQ(lib->mul, eager->mul);
+}
+
+TEST(Lazy, SurvivesMove) {
+  auto lib   = erl::Library<Interface, erl::lazy>(ERL_TEST_LIBRARY);
+  auto moved = std::move(lib);
+  EXPECT_EQ(moved->add(20, 22), 42);
+}
+
+TEST(Lazy, MissingSymbolThrowsOnCall) {
+  auto lib = erl::Library<Missing, erl::lazy>(ERL_TEST_LIBRARY);
+  EXPECT_EQ(lib->add(1, 1), 2);
+  EXPECT_THROW(lib->does_not_exist(1, 1), erl::LibraryError);
+}
+
+TEST(Lazy, StubOutlivingLibraryThrows) {
+  auto add = [] {
+    auto lib = erl::Library<Interface, erl::lazy>(ERL_TEST_LIBRARY);
+    return lib->add;
+  }();
+  EXPECT_THROW(add(1, 2), erl::LibraryError);
+}
+
+TEST(Lazy, ResolveAllReportsUpFront) {
+  auto lib = erl::Library<Missing, erl::lazy>(ERL_TEST_LIBRARY);
+  EXPECT_THROW(lib.resolve_all(), erl::LibraryError);
+
+  auto ok = erl::Library<Interface, erl::lazy>(ERL_TEST_LIBRARY);
+  ok.resolve_all();
+  auto eager = erl::Library<Interface>(ERL_TEST_LIBRARY);
+  EXPECT_EQ(ok->mul, eager->mul);
+}
+
+TEST(Lazy, ExtraInstancesResolveEagerly) {
+  using Lib   = erl::Library<Interface, erl::basic_lazy<1> >;
+  auto first  = Lib(ERL_TEST_LIBRARY);
+  auto second = Lib(ERL_TEST_LIBRARY);
+  auto eager  = erl::Library<Interface>(ERL_TEST_LIBRARY);
+
+  EXPECT_NE(first->mul, eager->mul);
+  EXPECT_EQ(second->mul, eager->mul);
+  EXPECT_EQ(second->add(1, 2), 3);
+  second.resolve_all();
+
+  using Missing1 = erl::Library<Missing, erl::basic_lazy<1> >;
+  auto stubbed   = Missing1(ERL_TEST_LIBRARY);
+  EXPECT_THROW(Missing1(ERL_TEST_LIBRARY), erl::LibraryError);
+}
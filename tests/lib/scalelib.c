@@ -0,0 +1,42 @@
+// 2000 generated exports for the nested Wrapper scale test, fn_GGMM for 40 groups of 50 members
+#if defined(_WIN32) || defined(_WIN64)
+#define EXPORT __declspec(dllexport)
+#else
+#define EXPORT
+#endif
+
+#define DEFINE_FN(N) \
+  EXPORT int fn_##N(int value) { return value + 1##N; }
+#define DEFINE_FN10(N) \
+  DEFINE_FN(N##0)      \
+  DEFINE_FN(N##1)      \
+  DEFINE_FN(N##2)      \
+  DEFINE_FN(N##3)      \
+  DEFINE_FN(N##4)      \
+  DEFINE_FN(N##5)      \
+  DEFINE_FN(N##6)      \
+  DEFINE_FN(N##7)      \
+  DEFINE_FN(N##8)      \
+  DEFINE_FN(N##9)
+#define DEFINE_GROUP(G) \
+  DEFINE_FN10(G##0)     \
+  DEFINE_FN10(G##1)     \
+  DEFINE_FN10(G##2)     \
+  DEFINE_FN10(G##3)     \
+  DEFINE_FN10(G##4)
+#define DEFINE_GROUP10(G) \
+  DEFINE_GROUP(G##0)      \
+  DEFINE_GROUP(G##1)      \
+  DEFINE_GROUP(G##2)      \
+  DEFINE_GROUP(G##3)      \
+  DEFINE_GROUP(G##4)      \
+  DEFINE_GROUP(G##5)      \
+  DEFINE_GROUP(G##6)      \
+  DEFINE_GROUP(G##7)      \
+  DEFINE_GROUP(G##8)      \
+  DEFINE_GROUP(G##9)
+
+DEFINE_GROUP10(0)
+DEFINE_GROUP10(1)
+DEFINE_GROUP10(2)
+DEFINE_GROUP10(3)
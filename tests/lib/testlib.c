@@ -0,0 +1,119 @@
+#include <stdarg.h>
+#include <stdio.h>
+
+#if defined(_WIN32) || defined(_WIN64)
+#define EXPORT __declspec(dllexport)
+#else
+#define EXPORT
+#endif
+
+#ifndef TESTLIB_VERSION
+#define TESTLIB_VERSION 1
+#endif
+
+EXPORT int counter = 0;
+
+EXPORT int version(void) {
+  return TESTLIB_VERSION;
+}
+
+EXPORT int add(int a, int b) {
+  ++counter;
+  return a + b;
+}
+
+EXPORT int mul(int a, int b) {
+  ++counter;
+  return a * b;
+}
+
+EXPORT int sum(int count, ...) {
+  va_list args;
+  va_start(args, count);
+  int total = 0;
+  for (int idx = 0; idx < count; ++idx) {
+    total += va_arg(args, int);
+  }
+  va_end(args);
+  return total;
+}
+
+EXPORT int print(char const* str) {
+  return puts(str);
+}
+
+/* one kernel built for several instruction sets, each returning its level */
+EXPORT int dot(void) {
+  return 0;
+}
+
+EXPORT int dot_sse42(void) {
+  return 1;
+}
+
+EXPORT int dot_avx2(void) {
+  return 2;
+}
+
+EXPORT int dot_avx512(void) {
+  return 3;
+}
+
+#ifdef __ELF__
+/* resolved by the loader through its IFUNC resolver, which may pick another implementation on another CPU */
+static int indirect_impl(void) {
+  return 7;
+}
+
+static int (*resolve_indirect(void))(void) {
+  return indirect_impl;
+}
+
+EXPORT int indirect(void) __attribute__((ifunc("resolve_indirect")));
+#endif
+
+/* only some levels provided */
+EXPORT int blend(void) {
+  return 0;
+}
+
+EXPORT int blend_avx2(void) {
+  return 2;
+}
+
+EXPORT int scale_sse42(void) {
+  return 1;
+}
+
+#define DEFINE_FN(N) \
+  EXPORT int fn_##N(void) { return N; }
+#define DEFINE_FN8(N)  \
+  DEFINE_FN(N##0)      \
+  DEFINE_FN(N##1)      \
+  DEFINE_FN(N##2)      \
+  DEFINE_FN(N##3)      \
+  DEFINE_FN(N##4)      \
+  DEFINE_FN(N##5)      \
+  DEFINE_FN(N##6)      \
+  DEFINE_FN(N##7)
+
+DEFINE_FN8(0)
+DEFINE_FN8(1)
+DEFINE_FN8(2)
+DEFINE_FN8(3)
+DEFINE_FN8(4)
+DEFINE_FN8(5)
+DEFINE_FN8(6)
+DEFINE_FN8(7)
+
+#ifdef TESTLIB_LARGE_TEXT
+/* 3 MiB of code on either side, so padded_answer always lies within an aligned 2 MiB block of text.
+   Built with -fno-toplevel-reorder to keep the padding and the function in this order. */
+__asm__(".pushsection .text\n.skip 3145728\n.popsection\n");
+
+EXPORT int padded_answer(void) {
+  return 42;
+}
+
+__asm__(".pushsection .text\n.skip 3145728\n.popsection\n");
+#endif
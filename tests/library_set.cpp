@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <atomic>
+
+#include <autoload/library_set.hpp>
+
+namespace {
+struct Math {
+  int (*add)(int, int);
+  int (*mul)(int, int);
+};
+
+struct Counter {
+  int* counter;
+};
+}  // namespace
+
+TEST(LibrarySet, LoadsEveryLibrary) {
+  auto set = erl::LibrarySet<Math, Counter>(ERL_TEST_LIBRARY, std::string{ERL_TEST_LIBRARY});
+  static_assert(decltype(set)::size() == 2);
+
+  EXPECT_EQ(set.get<0>()->add(1, 2), 3);
+  EXPECT_EQ(set.get<Math>()->mul(2, 3), 6);
+  EXPECT_NE(set.get<Counter>()->counter, nullptr);
+}
+
+TEST(LibrarySet, LoadAll) {
+  auto set = erl::load_all<Math, Math>(ERL_TEST_LIBRARY, ERL_TEST_LIBRARY);
+  EXPECT_EQ(set.get<1>()->add(20, 22), 42);
+}
+
+TEST(LibrarySet, AggregatesErrors) {
+  struct Missing {
+    void (*does_not_exist)();
+  };
+
+  try {
+    auto set = erl::LibrarySet<Math, Missing, Counter>("/does/not/exist.so", ERL_TEST_LIBRARY, ERL_TEST_LIBRARY);
+    FAIL() << "expected LibrarySetError";
+  } catch (erl::LibrarySetError const& error) {
+    ASSERT_EQ(error.failures.size(), 2U);
+    EXPECT_EQ(error.failures[0].index, 0U);
+    EXPECT_EQ(error.failures[0].path, "/does/not/exist.so");
+    EXPECT_EQ(error.failures[1].index, 1U);
+    EXPECT_NE(error.failures[1].message.find("does_not_exist"), std::string::npos);
+  }
+}
+
+TEST(LibrarySet, PoolIsReusedAcrossRuns) {
+  auto pool = erl::_impl::WorkerPool(3);
+  ASSERT_EQ(pool.size(), 3U);
+
+  for (int run = 0; run < 50; ++run) {
+    auto seen   = std::array<std::atomic<int>, 64>{};
+    auto next   = std::atomic<std::size_t>{0};
+    auto worker = [&] {
+      for (auto idx = next.fetch_add(1); idx < seen.size(); idx = next.fetch_add(1)) {
+        seen[idx].fetch_add(1);
+      }
+    };
+    ASSERT_TRUE(pool.try_run(pool.size(), worker));
+    for (auto const& count : seen) {
+      EXPECT_EQ(count.load(), 1);
+    }
+  }
+}
+
+TEST(LibrarySet, BusyPoolRunsInline) {
+  auto pool   = erl::_impl::WorkerPool(1);
+  bool nested = true;
+  auto inner  = [] {};
+  auto outer  = [&] { nested = pool.try_run(1, inner); };
+  ASSERT_TRUE(pool.try_run(0, outer));
+  EXPECT_FALSE(nested);
+}
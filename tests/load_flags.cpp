@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+
+#include <autoload.hpp>
+
+namespace {
+struct Math {
+  int (*add)(int, int);
+  int (*mul)(int, int);
+};
+
+struct Versioned {
+  int (*version)();
+};
+
+bool is_loaded(char const* path) {
+  auto* handle = ::dlopen(path, RTLD_NOW | RTLD_NOLOAD);
+  if (handle != nullptr) {
+    ::dlclose(handle);
+  }
+  return handle != nullptr;
+}
+}  // namespace
+
+TEST(LoadFlags, ProbeBindsToLoadedLibrary) {
+  using Probe = erl::Library<Math, erl::load_flags<erl::LoadFlag::no_load> >;
+  ASSERT_FALSE(is_loaded(ERL_TEST_LIBRARY));
+  EXPECT_THROW(Probe(ERL_TEST_LIBRARY), erl::LibraryError);
+  EXPECT_FALSE(is_loaded(ERL_TEST_LIBRARY));
+
+  auto loaded = erl::Library<Math>(ERL_TEST_LIBRARY);
+  auto probe  = Probe(ERL_TEST_LIBRARY);
+  EXPECT_EQ(probe.native_handle(), loaded.native_handle());
+  EXPECT_EQ(probe->add(2, 3), 5);
+}
+
+TEST(LoadFlags, LazyBinding) {
+  auto lib = erl::Library<Math, erl::load_flags<erl::LoadFlag::lazy_binding> >(ERL_TEST_LIBRARY);
+  EXPECT_EQ(lib->mul(6, 7), 42);
+}
+
+// global symbols interpose on everything loaded later and binding through the global scope pins the library,
+// so this runs in a child process
+TEST(LoadFlags, GlobalSymbolsAreVisible) {
+  using Global = erl::Library<Math, erl::load_flags<erl::LoadFlag::global> >;
+  EXPECT_EXIT(
+      {
+        auto lib = Global(ERL_TEST_LIBRARY);
+        std::exit(::dlsym(RTLD_DEFAULT, "mul") == reinterpret_cast<void*>(lib->mul) ? 0 : 1);
+      },
+      testing::ExitedWithCode(0), "");
+}
+
+TEST(LoadFlags, NoDeleteKeepsLibraryMapped) {
+  {
+    using Resident = erl::Library<Versioned, erl::load_flags<erl::LoadFlag::no_delete | erl::LoadFlag::deep_bind> >;
+    auto lib       = Resident(ERL_TEST_LIBRARY_V2);
+    EXPECT_EQ(lib->version(), 2);
+  }
+  EXPECT_TRUE(is_loaded(ERL_TEST_LIBRARY_V2));
+}
+
+TEST(LoadFlags, SharedRegistriesAreSeparatedByFlags) {
+  auto plain = erl::Library<Math, erl::shared>(ERL_TEST_LIBRARY);
+  auto lazy  = erl::Library<Math, erl::shared, erl::load_flags<erl::LoadFlag::lazy_binding> >(ERL_TEST_LIBRARY);
+  EXPECT_EQ(lazy->add(1, 1), 2);
+  EXPECT_EQ(plain->add(1, 1), 2);
+}
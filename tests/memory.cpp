@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+#include <autoload.hpp>
+
+#if ERL_HAS_MEMFD
+namespace {
+struct Math {
+  int (*add)(int, int);
+  int* counter;
+};
+
+std::vector<std::byte> read_image(char const* path) {
+  auto file  = std::ifstream(path, std::ios::binary);
+  auto bytes = std::vector<char>(std::istreambuf_iterator<char>(file), {});
+  auto image = std::vector<std::byte>(bytes.size());
+  std::memcpy(image.data(), bytes.data(), bytes.size());
+  return image;
+}
+}  // namespace
+
+TEST(Memory, LoadFromImage) {
+  auto image = read_image(ERL_TEST_LIBRARY);
+  auto lib   = erl::Library<Math>(std::span<std::byte const>{image});
+  EXPECT_EQ(lib->add(2, 3), 5);
+
+  // every image is a new file to the loader
+  auto other = erl::Library<Math>(std::span<std::byte const>{image});
+  EXPECT_NE(lib->counter, other->counter);
+}
+
+TEST(Memory, LoadFromRegularFile) {
+  int fd   = ::open(ERL_TEST_LIBRARY, O_RDONLY | O_CLOEXEC);
+  auto lib = erl::Library<Math>(erl::from_fd, fd);
+  EXPECT_EQ(lib->add(1, 1), 2);
+  EXPECT_EQ(::close(fd), 0);
+}
+
+TEST(Memory, LoadFromPipe) {
+  auto image = read_image(ERL_TEST_LIBRARY);
+  int fds[2];
+  ASSERT_EQ(::pipe(fds), 0);
+
+  auto writer = std::jthread([&] {
+    auto const* data = image.data();
+    auto left        = image.size();
+    while (left != 0) {
+      auto written = ::write(fds[1], data, left);
+      if (written <= 0) {
+        break;
+      }
+      data += written;
+      left -= static_cast<std::size_t>(written);
+    }
+    ::close(fds[1]);
+  });
+
+  auto lib = erl::Library<Math>(erl::from_fd, fds[0]);
+  EXPECT_EQ(lib->add(4, 5), 9);
+  ::close(fds[0]);
+}
+
+TEST(Memory, InvalidImage) {
+  auto garbage = std::vector<std::byte>(4096, std::byte{0x42});
+  using Lib    = erl::Library<Math>;
+  EXPECT_THROW(Lib(std::span<std::byte const>{garbage}), erl::LibraryError);
+}
+#endif
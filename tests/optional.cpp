@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include <autoload.hpp>
+
+namespace {
+struct Plugin {
+  int (*add)(int, int);
+  erl::Optional<int (*)(int, int)> mul;
+  erl::Optional<int (*)(int, int)> newer_entry_point;
+  erl::Optional<int*> counter;
+  erl::Optional<int*> newer_data;
+};
+
+struct Broken {
+  int (*first_missing)();
+  int (*add)(int, int);
+  erl::Optional<void (*)()> optional_missing;
+  int* second_missing;
+};
+}  // namespace
+
+TEST(Optional, MissingOptionalMembersStayNull) {
+  auto lib = erl::Library<Plugin>(ERL_TEST_LIBRARY);
+  EXPECT_EQ(lib->add(1, 2), 3);
+
+  ASSERT_TRUE(lib->mul);
+  EXPECT_EQ(lib->mul(6, 7), 42);
+  EXPECT_FALSE(lib->newer_entry_point);
+  EXPECT_EQ(lib->newer_entry_point, nullptr);
+
+  ASSERT_TRUE(lib->counter);
+  auto before = *lib->counter;
+  lib->add(0, 0);
+  EXPECT_EQ(*lib->counter, before + 1);
+  EXPECT_FALSE(lib->newer_data);
+}
+
+TEST(Optional, ReportsEveryMissingRequiredSymbol) {
+  try {
+    auto lib = erl::Library<Broken>(ERL_TEST_LIBRARY);
+    FAIL() << "expected MissingSymbolError";
+  } catch (erl::MissingSymbolError const& error) {
+    ASSERT_EQ(error.symbols.size(), 2U);
+    EXPECT_EQ(error.symbols[0], "first_missing");
+    EXPECT_EQ(error.symbols[1], "second_missing");
+    EXPECT_EQ(error.path, ERL_TEST_LIBRARY);
+    EXPECT_EQ(std::string{error.what()}, std::string{ERL_TEST_LIBRARY} + ": undefined symbols: first_missing, second_missing");
+  }
+}
+
+TEST(Optional, LazyResolveAllReportsEveryMissingSymbol) {
+  struct LazyBroken {
+    int (*first_missing)();
+    int (*add)(int, int);
+    int (*second_missing)(int);
+  };
+
+  auto lib = erl::Library<LazyBroken, erl::lazy>(ERL_TEST_LIBRARY);
+  try {
+    lib.resolve_all();
+    FAIL() << "expected MissingSymbolError";
+  } catch (erl::MissingSymbolError const& error) {
+    ASSERT_EQ(error.symbols.size(), 2U);
+    EXPECT_EQ(error.symbols[0], "first_missing");
+    EXPECT_EQ(error.symbols[1], "second_missing");
+  }
+  EXPECT_EQ(lib->add(1, 1), 2);
+}
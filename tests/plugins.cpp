@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+
+#include <autoload/plugins.hpp>
+
+namespace {
+namespace fs = std::filesystem;
+
+struct Math {
+  int (*add)(int, int);
+  int (*mul)(int, int);
+  erl::Optional<void (*)()> newer_entry_point;
+};
+
+class Plugins : public testing::Test {
+protected:
+  fs::path directory;
+  fs::path manifest;
+
+  void SetUp() override {
+    directory = fs::temp_directory_path() / ("autoload_plugins_" + std::to_string(::getpid()));
+    manifest  = fs::temp_directory_path() / ("autoload_plugins_" + std::to_string(::getpid()) + ".manifest");
+    fs::create_directories(directory);
+
+    fs::copy_file(ERL_TEST_LIBRARY, directory / "a.so");
+    fs::copy_file(ERL_TEST_LIBRARY_V2, directory / "b.so");
+    fs::copy_file(ERL_TEST_LIBRARY_SCALE, directory / "other.so");
+    std::ofstream(directory / "broken.so") << "not an ELF file";
+    std::ofstream(directory / "readme.txt") << "ignored";
+  }
+
+  void TearDown() override {
+    erl::set_cpu_level(std::nullopt);
+    fs::remove_all(directory);
+    fs::remove(manifest);
+  }
+};
+}  // namespace
+
+TEST_F(Plugins, LoadsMatchingLibraries) {
+  auto scan = erl::scan_plugins<Math>(directory);
+  EXPECT_EQ(scan.candidates, 4U);
+  EXPECT_EQ(scan.rejected, 2U);
+  EXPECT_TRUE(scan.failures.empty());
+
+  ASSERT_EQ(scan.plugins.size(), 2U);
+  EXPECT_EQ(scan.plugins[0].path.filename(), "a.so");
+  EXPECT_EQ(scan.plugins[1].path.filename(), "b.so");
+  EXPECT_EQ(scan.plugins[0].library->add(1, 2), 3);
+  EXPECT_EQ(scan.plugins[1].library->mul(2, 3), 6);
+}
+
+TEST_F(Plugins, ManifestSkipsUnchangedFiles) {
+  {
+    auto first = erl::scan_plugins<Math>(directory, manifest);
+    EXPECT_EQ(first.unchanged, 0U);
+    EXPECT_EQ(first.plugins.size(), 2U);
+  }
+  ASSERT_TRUE(fs::exists(manifest));
+
+  {
+    auto second = erl::scan_plugins<Math>(directory, manifest);
+    EXPECT_EQ(second.unchanged, 4U);
+    EXPECT_EQ(second.rejected, 2U);
+    EXPECT_EQ(second.plugins.size(), 2U);
+  }
+
+  fs::remove(directory / "b.so");
+  fs::copy_file(ERL_TEST_LIBRARY_SCALE, directory / "b.so");
+  auto third = erl::scan_plugins<Math>(directory, manifest);
+  EXPECT_EQ(third.unchanged, 3U);
+  ASSERT_EQ(third.plugins.size(), 1U);
+  EXPECT_EQ(third.plugins[0].path.filename(), "a.so");
+}
+
+TEST_F(Plugins, ManifestIsKeyedByInterface) {
+  struct Scale {
+    int (*fn_0000)(int);
+  };
+
+  erl::scan_plugins<Math>(directory, manifest);
+  auto scan = erl::scan_plugins<Scale>(directory, manifest);
+  EXPECT_EQ(scan.unchanged, 0U);
+  ASSERT_EQ(scan.plugins.size(), 1U);
+  EXPECT_EQ(scan.plugins[0].path.filename(), "other.so");
+  EXPECT_EQ(scan.plugins[0].library->fn_0000(1), 10001);
+}
+
+TEST_F(Plugins, LazyPluginsBeyondSlotCount) {
+  for (int idx = 0; idx < 6; ++idx) {
+    fs::copy_file(ERL_TEST_LIBRARY, directory / ("extra_" + std::to_string(idx) + ".so"));
+  }
+  auto scan = erl::scan_plugins<Math, erl::basic_lazy<2> >(directory);
+  EXPECT_TRUE(scan.failures.empty());
+  ASSERT_EQ(scan.plugins.size(), 8U);
+  for (auto& plugin : scan.plugins) {
+    EXPECT_EQ(plugin.library->add(2, 3), 5);
+  }
+}
+
+TEST_F(Plugins, VariantsSatisfyRequiredMembers) {
+  // the test libraries export `scale` only as `scale_sse42`
+  struct Kernels {
+    int (*scale)();
+  };
+  EXPECT_TRUE(erl::scan_plugins<Kernels>(directory).plugins.empty());
+
+  erl::set_cpu_level(erl::CpuLevel::sse42);
+  auto scan = erl::scan_plugins<Kernels, erl::variants>(directory, manifest);
+  ASSERT_EQ(scan.plugins.size(), 2U);
+  EXPECT_EQ(scan.plugins[0].library->scale(), 1);
+
+  // baseline accepts the plain name only
+  erl::set_cpu_level(erl::CpuLevel::baseline);
+  scan = erl::scan_plugins<Kernels, erl::variants>(directory, manifest);
+  EXPECT_TRUE(scan.plugins.empty());
+}
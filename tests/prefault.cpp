@@ -0,0 +1,60 @@
+#include <gtest/gtest.h>
+
+#include <autoload.hpp>
+
+#if ERL_HAS_ELF_LOOKUP
+#  include <sys/mman.h>
+#  include <unistd.h>
+
+namespace {
+struct Math {
+  int (*add)(int, int);
+  int* counter;
+};
+
+bool is_resident(void const* address) {
+  auto page  = static_cast<std::uintptr_t>(::sysconf(_SC_PAGESIZE));
+  auto begin = reinterpret_cast<std::uintptr_t>(address) & ~(page - 1);
+  unsigned char vector = 0;
+  return ::mincore(reinterpret_cast<void*>(begin), page, &vector) == 0 && (vector & 1U) != 0;
+}
+}  // namespace
+
+TEST(Prefault, ReportsPrefaultedBytes) {
+  auto stats = erl::LoadStats{};
+  auto lib   = erl::Library<Math, erl::prefault>(ERL_TEST_LIBRARY, stats);
+  auto page  = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+
+  EXPECT_GT(stats.prefaulted_bytes, 0U);
+  EXPECT_EQ(stats.prefaulted_bytes % page, 0U);
+  EXPECT_EQ(stats.locked_bytes, 0U);
+  EXPECT_TRUE(is_resident(reinterpret_cast<void const*>(lib->add)));
+  EXPECT_TRUE(is_resident(lib->counter));
+  EXPECT_EQ(lib->add(1, 2), 3);
+}
+
+TEST(Prefault, PinnedLocksAsFarAsPermitted) {
+  auto stats = erl::LoadStats{};
+  auto lib   = erl::Library<Math, erl::pinned>(ERL_TEST_LIBRARY, stats);
+  EXPECT_GT(stats.prefaulted_bytes, 0U);
+  // RLIMIT_MEMLOCK may deny locking some or all segments
+  EXPECT_LE(stats.locked_bytes, stats.prefaulted_bytes);
+  EXPECT_EQ(lib->add(2, 2), 4);
+}
+
+TEST(Prefault, WithoutPolicyNothingIsReported) {
+  auto stats = erl::LoadStats{};
+  auto lib   = erl::Library<Math>(ERL_TEST_LIBRARY, stats);
+  EXPECT_EQ(stats.prefaulted_bytes, 0U);
+  EXPECT_EQ(stats.prefault_time, erl::LoadStats::clock::duration{});
+}
+
+TEST(Prefault, PlatformHelper) {
+  auto handle = erl::platform::load_library(ERL_TEST_LIBRARY);
+  auto report = erl::platform::prefault(handle);
+  EXPECT_GT(report.bytes, 0U);
+  erl::platform::unload_library(handle);
+
+  EXPECT_EQ(erl::platform::prefault(nullptr).bytes, 0U);
+}
+#endif
@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <thread>
+
+#include <autoload/reloadable.hpp>
+
+namespace {
+namespace fs = std::filesystem;
+
+struct Versioned {
+  int (*version)();
+  int (*add)(int, int);
+};
+
+class Reloadable : public testing::Test {
+protected:
+  fs::path directory;
+  fs::path library;
+
+  void SetUp() override {
+    directory = fs::temp_directory_path() / ("autoload_reload_" + std::to_string(::getpid()));
+    fs::create_directories(directory);
+    library = directory / "libplugin.so";
+    fs::copy_file(ERL_TEST_LIBRARY, library, fs::copy_options::overwrite_existing);
+  }
+
+  void TearDown() override { fs::remove_all(directory); }
+
+  // replaces the library the way installers do, never modifying the mapped file in place
+  void install(char const* source) const {
+    auto staging = directory / "staging.so";
+    fs::copy_file(source, staging, fs::copy_options::overwrite_existing);
+    fs::rename(staging, library);
+  }
+};
+}  // namespace
+
+TEST_F(Reloadable, ReloadOnDemand) {
+  auto lib = erl::ReloadableLibrary<Versioned>(library.string());
+  EXPECT_EQ(lib->version(), 1);
+  EXPECT_EQ(lib.generation(), 1U);
+
+  install(ERL_TEST_LIBRARY_V2);
+  lib.reload();
+  EXPECT_EQ(lib->version(), 2);
+  EXPECT_EQ(lib->add(1, 2), 3);
+  EXPECT_EQ(lib.generation(), 2U);
+}
+
+TEST_F(Reloadable, FailedReloadKeepsCurrentSymbols) {
+  auto lib = erl::ReloadableLibrary<Versioned>(library.string());
+  fs::remove(library);
+  EXPECT_THROW(lib.reload(), erl::LibraryError);
+  EXPECT_EQ(lib->version(), 1);
+}
+
+TEST_F(Reloadable, ReadersDelayReclamation) {
+  auto lib    = erl::ReloadableLibrary<Versioned>(library.string());
+  auto reader = erl::reclamation::Reader{};
+
+  auto const* old_table = lib.operator->();
+  install(ERL_TEST_LIBRARY_V2);
+  lib.reload();
+
+  // the registered reader might still use the old table
+  EXPECT_EQ(lib.collect(), 0U);
+  EXPECT_EQ(old_table->version(), 1);
+
+  erl::reclamation::quiescent();
+  EXPECT_EQ(lib.collect(), 1U);
+  EXPECT_EQ(lib->version(), 2);
+}
+
+TEST_F(Reloadable, ConcurrentCallsDuringReload) {
+  auto lib     = erl::ReloadableLibrary<Versioned>(library.string());
+  auto running = std::atomic<bool>{true};
+
+  std::vector<std::jthread> readers;
+  for (int idx = 0; idx < 4; ++idx) {
+    readers.emplace_back([&] {
+      auto reader = erl::reclamation::Reader{};
+      while (running.load()) {
+        auto version = lib->version();
+        ASSERT_TRUE(version == 1 || version == 2);
+        erl::reclamation::quiescent();
+      }
+    });
+  }
+
+  for (int idx = 0; idx < 20; ++idx) {
+    install(idx % 2 == 0 ? ERL_TEST_LIBRARY_V2 : ERL_TEST_LIBRARY);
+    lib.reload();
+  }
+  running.store(false);
+  readers.clear();
+
+  lib.synchronize();
+  EXPECT_EQ(lib.generation(), 21U);
+}
+
+TEST_F(Reloadable, WatchesFile) {
+  auto lib = erl::ReloadableLibrary<Versioned>(library.string());
+  lib.watch();
+
+  install(ERL_TEST_LIBRARY_V2);
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (lib->version() != 2 && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(lib->version(), 2);
+}
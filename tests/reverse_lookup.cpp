@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <csignal>
+#include <string>
+
+#include <autoload.hpp>
+
+#if ERL_HAS_ELF_LOOKUP
+namespace {
+struct Math {
+  int (*add)(int, int);
+  int (*mul)(int, int);
+  int (*fn_00)();
+  int (*fn_77)();
+};
+
+using Indexed = erl::Library<Math, erl::reverse_lookup>;
+
+void const* address_of(auto fnc) {
+  return reinterpret_cast<void const*>(fnc);
+}
+
+erl::platform::elf::AddressIndex const* signal_index = nullptr;
+void const* signal_address                            = nullptr;
+erl::platform::elf::AddressInfo signal_result{};
+
+void on_signal(int) {
+  signal_result = signal_index->lookup(signal_address);
+}
+}  // namespace
+
+TEST(ReverseLookup, NamesFunctionAddresses) {
+  auto lib          = Indexed(ERL_TEST_LIBRARY);
+  auto const& index = lib.address_index();
+  ASSERT_FALSE(index.empty());
+
+  auto info = index.lookup(address_of(lib->add));
+  ASSERT_TRUE(info);
+  EXPECT_EQ(info.name, "add");
+  EXPECT_EQ(info.symbol, reinterpret_cast<std::uintptr_t>(lib->add));
+  EXPECT_EQ(info.offset, 0U);
+  EXPECT_EQ(info.name.data()[info.name.size()], '\0');
+
+  auto inside = index.lookup(reinterpret_cast<std::uintptr_t>(lib->mul) + 1);
+  EXPECT_EQ(inside.name, "mul");
+  EXPECT_EQ(inside.offset, 1U);
+
+  EXPECT_FALSE(index.lookup(address_of(&address_of<int (*)()>)));
+  EXPECT_FALSE(index.lookup(std::uintptr_t{0}));
+}
+
+TEST(ReverseLookup, AgreesWithDladdr) {
+  auto lib = Indexed(ERL_TEST_LIBRARY);
+  for (auto const* address : {address_of(lib->add), address_of(lib->mul), address_of(lib->fn_00),
+                              address_of(lib->fn_77)}) {
+    Dl_info expected{};
+    ASSERT_NE(::dladdr(address, &expected), 0);
+    EXPECT_EQ(lib.address_index().lookup(address).name, expected.dli_sname);
+  }
+}
+
+TEST(ReverseLookup, SymbolizesBatches) {
+  auto lib       = Indexed(ERL_TEST_LIBRARY);
+  auto addresses = std::array{address_of(lib->add), static_cast<void const*>(reinterpret_cast<char const*>(lib->add) + 2),
+                              address_of(lib->mul), static_cast<void const*>(nullptr)};
+  auto out       = std::array<erl::platform::elf::AddressInfo, addresses.size()>{};
+
+  lib.address_index().symbolize(addresses, out);
+  EXPECT_EQ(out[0].name, "add");
+  EXPECT_EQ(out[1].name, "add");
+  EXPECT_EQ(out[1].offset, 2U);
+  EXPECT_EQ(out[2].name, "mul");
+  EXPECT_FALSE(out[3]);
+}
+
+TEST(ReverseLookup, SurvivesMove) {
+  auto lib   = Indexed(ERL_TEST_LIBRARY);
+  auto moved = std::move(lib);
+  EXPECT_EQ(moved.address_index().lookup(address_of(moved->mul)).name, "mul");
+}
+
+TEST(ReverseLookup, LookupFromSignalHandler) {
+  auto lib       = Indexed(ERL_TEST_LIBRARY);
+  signal_index   = &lib.address_index();
+  signal_address = address_of(lib->fn_77);
+
+  auto previous = std::signal(SIGUSR1, on_signal);
+  std::raise(SIGUSR1);
+  std::signal(SIGUSR1, previous);
+  EXPECT_EQ(signal_result.name, "fn_77");
+}
+#endif
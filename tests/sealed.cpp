@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+
+#include <unistd.h>
+
+#include <autoload.hpp>
+
+namespace {
+struct Math {
+  int* counter;
+  int (*add)(int, int);
+  int (*mul)(int, int);
+  erl::Optional<void (*)()> newer_entry_point;
+};
+
+using Sealed = erl::Library<Math, erl::sealed>;
+
+std::uintptr_t address_of(void const* pointer) {
+  return reinterpret_cast<std::uintptr_t>(pointer);
+}
+}  // namespace
+
+TEST(Sealed, CallsThroughTable) {
+  auto lib   = Sealed(ERL_TEST_LIBRARY);
+  auto eager = erl::Library<Math>(ERL_TEST_LIBRARY);
+
+  EXPECT_EQ(lib->add(1, 2), 3);
+  EXPECT_EQ((*lib).mul(2, 3), 6);
+  EXPECT_EQ(lib->counter, eager->counter);
+  EXPECT_FALSE(lib->newer_entry_point);
+}
+
+TEST(Sealed, TableLivesOnItsOwnPages) {
+  auto lib          = Sealed(ERL_TEST_LIBRARY);
+  auto const* table = lib.operator->();
+  EXPECT_NE(address_of(table), address_of(&lib));
+  EXPECT_EQ(address_of(table) % static_cast<std::uintptr_t>(::sysconf(_SC_PAGESIZE)), 0U);
+}
+
+// the suffix runs it before other suites leave worker threads behind, re-executing keeps it safe regardless
+TEST(SealedDeathTest, StrayWritesFault) {
+  auto style                            = testing::GTEST_FLAG(death_test_style);
+  testing::GTEST_FLAG(death_test_style) = "threadsafe";
+  auto lib                              = Sealed(ERL_TEST_LIBRARY);
+  auto* table                           = const_cast<Math*>(lib.operator->());
+  EXPECT_DEATH(table->add = nullptr, "");
+  testing::GTEST_FLAG(death_test_style) = style;
+}
+
+TEST(Sealed, HotMembersStartACacheLine) {
+  using Hot = erl::Library<Math, erl::sealed, erl::hot<"mul">>;
+  auto lib  = Hot(ERL_TEST_LIBRARY);
+  EXPECT_EQ(address_of(&lib->mul) % 64, 0U);
+  EXPECT_EQ(lib->mul(6, 7), 42);
+}
+
+TEST(Sealed, HotMembersShareOneLine) {
+  using Hot = erl::Library<Math, erl::sealed, erl::hot<"add", "mul">>;
+  auto lib = Hot(ERL_TEST_LIBRARY);
+  EXPECT_EQ(address_of(&lib->add) % 64, 0U);
+  EXPECT_EQ(address_of(&lib->mul) / 64, address_of(&lib->add) / 64);
+  EXPECT_EQ(address_of(lib.operator->()) % alignof(Math), 0U);
+}
+
+static_assert(erl::reflection::symbol_layout_exact<Math>);
+static_assert(erl::reflection::symbol_extents<Math>[2].first == offsetof(Math, mul));
+
+TEST(Sealed, SurvivesMove) {
+  auto lib          = Sealed(ERL_TEST_LIBRARY);
+  auto const* table = lib.operator->();
+  auto moved        = std::move(lib);
+  EXPECT_EQ(moved.operator->(), table);
+  EXPECT_EQ(moved->add(20, 22), 42);
+
+  auto other = Sealed(ERL_TEST_LIBRARY);
+  other      = std::move(moved);
+  EXPECT_EQ(other.operator->(), table);
+}
+
+TEST(Sealed, CombinesWithShared) {
+  auto first  = erl::Library<Math, erl::shared, erl::sealed>(ERL_TEST_LIBRARY);
+  auto second = erl::Library<Math, erl::shared, erl::sealed>(ERL_TEST_LIBRARY);
+  EXPECT_EQ(first->add, second->add);
+  EXPECT_EQ(second->mul(2, 4), 8);
+}
@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include <autoload.hpp>
+
+namespace {
+struct Math {
+  int (*add)(int, int);
+  int (*mul)(int, int);
+};
+
+bool is_loaded(char const* path) {
+  auto* handle = ::dlopen(path, RTLD_NOW | RTLD_NOLOAD);
+  if (handle != nullptr) {
+    ::dlclose(handle);
+  }
+  return handle != nullptr;
+}
+}  // namespace
+
+TEST(Shared, InstancesShareOneHandle) {
+  auto first  = erl::Library<Math, erl::shared>(ERL_TEST_LIBRARY);
+  auto second = erl::Library<Math, erl::shared>(std::string_view{ERL_TEST_LIBRARY});
+  EXPECT_EQ(first.native_handle(), second.native_handle());
+  EXPECT_EQ(first->add, second->add);
+  EXPECT_EQ(second->mul(6, 7), 42);
+}
+
+TEST(Shared, LastInstanceClosesHandle) {
+  ASSERT_FALSE(is_loaded(ERL_TEST_LIBRARY_SHARED));
+  {
+    auto first = erl::Library<Math, erl::shared>(ERL_TEST_LIBRARY_SHARED);
+    {
+      auto second = erl::Library<Math, erl::shared>(ERL_TEST_LIBRARY_SHARED);
+    }
+    EXPECT_TRUE(is_loaded(ERL_TEST_LIBRARY_SHARED));
+    auto moved = std::move(first);
+    EXPECT_EQ(moved->add(1, 2), 3);
+  }
+  EXPECT_FALSE(is_loaded(ERL_TEST_LIBRARY_SHARED));
+
+  // a closed entry is reopened on demand
+  auto revived = erl::Library<Math, erl::shared>(ERL_TEST_LIBRARY_SHARED);
+  EXPECT_EQ(revived->add(2, 2), 4);
+}
+
+TEST(Shared, WrapperTypesKeepSeparateTables) {
+  struct Adder {
+    int (*add)(int, int);
+  };
+  auto math  = erl::Library<Math, erl::shared>(ERL_TEST_LIBRARY);
+  auto adder = erl::Library<Adder, erl::shared>(ERL_TEST_LIBRARY);
+  // the loader still hands both the same reference counted handle
+  EXPECT_EQ(math.native_handle(), adder.native_handle());
+  EXPECT_EQ(math->add, adder->add);
+}
+
+TEST(Shared, MissingSymbolLeavesRegistryUsable) {
+  struct Missing {
+    void (*does_not_exist)();
+  };
+  using Lib = erl::Library<Missing, erl::shared>;
+  EXPECT_THROW(Lib(ERL_TEST_LIBRARY), erl::LibraryError);
+  EXPECT_THROW(Lib(ERL_TEST_LIBRARY), erl::LibraryError);
+}
+
+TEST(Shared, ConcurrentAcquireAndRelease) {
+  std::vector<std::jthread> threads;
+  for (int idx = 0; idx < 8; ++idx) {
+    threads.emplace_back([] {
+      for (int iteration = 0; iteration < 200; ++iteration) {
+        auto lib = erl::Library<Math, erl::shared>(ERL_TEST_LIBRARY);
+        ASSERT_EQ(lib->add(iteration, 1), iteration + 1);
+      }
+    });
+  }
+}
@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include <autoload/trace.hpp>
+
+namespace {
+struct Math {
+  int* counter;
+  int (*add)(int, int);
+};
+
+struct Missing {
+  int (*add)(int, int);
+  void (*does_not_exist)();
+};
+
+// parks the loading thread inside on_load until released
+struct BlockingObserver : erl::LoadObserver {
+  std::atomic<bool> entered{false};
+  std::atomic<bool> released{false};
+
+  void on_load(erl::LoadStats const&) override {
+    entered = true;
+    entered.notify_all();
+    released.wait(false);
+  }
+};
+
+struct ObserverGuard {
+  explicit ObserverGuard(erl::LoadObserver& observer) { erl::set_load_observer(&observer); }
+  ~ObserverGuard() { erl::set_load_observer(nullptr); }
+};
+}  // namespace
+
+TEST(Trace, StatsOnSuccess) {
+  auto stats = erl::LoadStats{};
+  auto lib   = erl::Library<Math>(ERL_TEST_LIBRARY, stats);
+
+  EXPECT_EQ(stats.path, ERL_TEST_LIBRARY);
+  EXPECT_EQ(stats.symbol_count, 2U);
+  ASSERT_EQ(stats.symbols.size(), 2U);
+  EXPECT_EQ(stats.symbols[0].name, "counter");
+  EXPECT_EQ(stats.symbols[1].name, "add");
+  EXPECT_GT(stats.open_time.count(), 0);
+  EXPECT_FALSE(stats.failure.has_value());
+  EXPECT_TRUE(stats.error.empty());
+}
+
+TEST(Trace, StatsOnFailure) {
+  auto stats = erl::LoadStats{};
+  EXPECT_THROW(erl::Library<Missing>(ERL_TEST_LIBRARY, stats), erl::LibraryError);
+
+  ASSERT_TRUE(stats.failure.has_value());
+  EXPECT_EQ(stats.failure->index, 1U);
+  EXPECT_EQ(stats.failure->name, "does_not_exist");
+  EXPECT_EQ(stats.symbols.size(), 2U);
+  EXPECT_FALSE(stats.error.empty());
+}
+
+TEST(Trace, ExporterWritesTraceEvents) {
+  auto exporter = erl::TraceExporter{};
+  {
+    auto guard = ObserverGuard(exporter);
+    auto lib   = erl::Library<Math>(ERL_TEST_LIBRARY);
+    EXPECT_THROW(erl::Library<Missing>(ERL_TEST_LIBRARY), erl::LibraryError);
+  }
+  auto unobserved = erl::Library<Math>(ERL_TEST_LIBRARY);
+  ASSERT_EQ(exporter.size(), 2U);
+
+  auto json = exporter.json();
+  EXPECT_EQ(json.rfind("{\"traceEvents\":[", 0), 0U);
+  EXPECT_NE(json.find("\"name\":\"open\""), std::string::npos);
+  EXPECT_NE(json.find("\"name\":\"add\",\"cat\":\"autoload.symbol\""), std::string::npos);
+  EXPECT_NE(json.find("\"failed_symbol\":\"does_not_exist\""), std::string::npos);
+
+  // thread ids stay within the integers JSON represents exactly
+  auto tid = json.find("\"tid\":");
+  ASSERT_NE(tid, std::string::npos);
+  EXPECT_LT(std::stoull(json.substr(tid + 6)), 1ULL << 53);
+}
+
+TEST(Trace, WriteKeepsStreamFormatting) {
+  auto exporter = erl::TraceExporter{};
+  {
+    auto guard = ObserverGuard(exporter);
+    auto lib   = erl::Library<Math>(ERL_TEST_LIBRARY);
+  }
+
+  auto out = std::ostringstream{};
+  out.precision(9);
+  out.fill('*');
+  auto flags = out.flags();
+  exporter.write(out);
+  EXPECT_EQ(out.precision(), 9);
+  EXPECT_EQ(out.fill(), '*');
+  EXPECT_EQ(out.flags(), flags);
+  EXPECT_EQ(out.str(), exporter.json());
+}
+
+TEST(Trace, RemovingObserverWaitsForLoads) {
+  auto observer = BlockingObserver{};
+  erl::set_load_observer(&observer);
+  auto loader = std::jthread([] { auto lib = erl::Library<Math>(ERL_TEST_LIBRARY); });
+  observer.entered.wait(false);
+
+  auto removed = std::atomic<bool>{false};
+  auto remover = std::jthread([&] {
+    erl::set_load_observer(nullptr);
+    removed = true;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_FALSE(removed);
+
+  observer.released = true;
+  observer.released.notify_all();
+  remover.join();
+  EXPECT_TRUE(removed);
+}
+
+TEST(Trace, SwappingObserverIgnoresNewerLoads) {
+  auto first  = BlockingObserver{};
+  auto second = BlockingObserver{};
+  erl::set_load_observer(&first);
+  auto older = std::jthread([] { auto lib = erl::Library<Math>(ERL_TEST_LIBRARY); });
+  first.entered.wait(false);
+
+  auto swapped = std::atomic<bool>{false};
+  auto swapper = std::jthread([&] {
+    erl::set_load_observer(&second);
+    swapped = true;
+    swapped.notify_all();
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_FALSE(swapped);
+
+  // reports to the new observer and stays parked there while the swap completes
+  auto newer = std::jthread([] { auto lib = erl::Library<Math>(ERL_TEST_LIBRARY); });
+  second.entered.wait(false);
+  first.released = true;
+  first.released.notify_all();
+  swapped.wait(false);
+  EXPECT_TRUE(swapped);
+
+  second.released = true;
+  second.released.notify_all();
+  newer.join();
+  erl::set_load_observer(nullptr);
+}
@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <optional>
+
+#include <autoload.hpp>
+
+namespace {
+struct Kernels {
+  int (*dot)();
+  int (*blend)();
+  erl::Optional<int (*)()> scale;
+  int (*add)(int, int);
+};
+
+using Dispatched = erl::Library<Kernels, erl::variants>;
+
+// runs without ERL_CPU_LEVEL from the environment and restores detection even if an assertion bails out early
+class Variants : public testing::Test {
+protected:
+  void SetUp() override {
+    ::unsetenv("ERL_CPU_LEVEL");
+    erl::set_cpu_level(std::nullopt);
+  }
+
+  void TearDown() override {
+    ::unsetenv("ERL_CPU_LEVEL");
+    erl::set_cpu_level(std::nullopt);
+  }
+};
+}  // namespace
+
+TEST_F(Variants, PicksMostCapableVariant) {
+  erl::set_cpu_level(erl::CpuLevel::avx512);
+  auto lib = Dispatched(ERL_TEST_LIBRARY);
+  EXPECT_EQ(lib->dot(), 3);
+  EXPECT_EQ(lib->blend(), 2);
+  EXPECT_EQ(lib->scale(), 1);
+  EXPECT_EQ(lib->add(1, 2), 3);
+}
+
+TEST_F(Variants, ForcedLevelLimitsChoice) {
+  erl::set_cpu_level(erl::CpuLevel::sse42);
+  auto sse42 = Dispatched(ERL_TEST_LIBRARY);
+  EXPECT_EQ(sse42->dot(), 1);
+  EXPECT_EQ(sse42->blend(), 0);
+  EXPECT_TRUE(sse42->scale);
+
+  erl::set_cpu_level(erl::CpuLevel::baseline);
+  auto baseline = Dispatched(ERL_TEST_LIBRARY);
+  EXPECT_EQ(baseline->dot(), 0);
+  EXPECT_FALSE(baseline->scale);
+
+  // already loaded libraries keep their binding
+  EXPECT_EQ(sse42->dot(), 1);
+}
+
+TEST_F(Variants, DefaultsToDetectedLevel) {
+  EXPECT_EQ(erl::cpu_level(), erl::detected_cpu_level());
+  auto lib = Dispatched(ERL_TEST_LIBRARY);
+  EXPECT_EQ(lib->dot(), static_cast<int>(erl::detected_cpu_level()));
+}
+
+TEST_F(Variants, ResetRereadsEnvironment) {
+  erl::set_cpu_level(erl::CpuLevel::avx2);
+  ::setenv("ERL_CPU_LEVEL", "sse42", 1);
+  EXPECT_EQ(erl::cpu_level(), erl::CpuLevel::avx2);
+
+  erl::set_cpu_level(std::nullopt);
+  EXPECT_EQ(erl::cpu_level(), erl::CpuLevel::sse42);
+}
+
+TEST_F(Variants, MissingEveryVariantFails) {
+  struct Missing {
+    int (*dot)();
+    int (*scale)();
+  };
+  erl::set_cpu_level(erl::CpuLevel::baseline);
+  EXPECT_THROW((erl::Library<Missing, erl::variants>(ERL_TEST_LIBRARY)), erl::MissingSymbolError);
+}
+
+TEST_F(Variants, LazyMembersPickOnFirstCall) {
+  erl::set_cpu_level(erl::CpuLevel::avx2);
+  auto lib = erl::Library<Kernels, erl::lazy, erl::variants>(ERL_TEST_LIBRARY);
+  EXPECT_EQ(lib->dot(), 2);
+  EXPECT_EQ(lib->blend(), 2);
+  lib.resolve_all();
+  EXPECT_EQ(lib->add(2, 2), 4);
+}